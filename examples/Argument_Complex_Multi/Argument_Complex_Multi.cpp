@@ -28,25 +28,25 @@
 
 #include "Argument_Complex_Multi.h"
 
-void TimerHandler(unsigned int outputPinsAddress)
+void TimerHandler(pinStruct outputPins)
 {
   static bool toggle = false;
 
   //timer interrupt toggles pins
 #if (TIMER_INTERRUPT_DEBUG > 1)
-  Serial.print("Toggle pin1 = "); Serial.println( ((pinStruct *) outputPinsAddress)->Pin1 );
+  Serial.print("Toggle pin1 = "); Serial.println( outputPins.Pin1 );
 #endif
   
-  digitalWrite(((pinStruct *) outputPinsAddress)->Pin1, toggle);
+  digitalWrite(outputPins.Pin1, toggle);
 
 #if (TIMER_INTERRUPT_DEBUG > 1)
-  Serial.print("Read pin2 A0 ("); Serial.print(((pinStruct *) outputPinsAddress)->Pin2 );
+  Serial.print("Read pin2 A0 ("); Serial.print(outputPins.Pin2 );
   Serial.print(") = ");
-  Serial.println(digitalRead(((pinStruct *) outputPinsAddress)->Pin2) ? "HIGH" : "LOW" );                          
+  Serial.println(digitalRead(outputPins.Pin2) ? "HIGH" : "LOW" );                          
 
-  Serial.print("Read pin3 A1 ("); Serial.print(((pinStruct *) outputPinsAddress)->Pin3 );
+  Serial.print("Read pin3 A1 ("); Serial.print(outputPins.Pin3 );
   Serial.print(") = ");
-  Serial.println(digitalRead(((pinStruct *) outputPinsAddress)->Pin3) ? "HIGH" : "LOW" );  
+  Serial.println(digitalRead(outputPins.Pin3) ? "HIGH" : "LOW" );  
 #endif
                  
   toggle = !toggle;
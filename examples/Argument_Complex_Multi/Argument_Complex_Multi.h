@@ -64,6 +64,7 @@ struct pinStruct
 
 #define TIMER_INTERVAL_MS    1000
 
-void TimerHandler(unsigned int outputPinsAddress);
+// outputPins is copied into the TimerInterrupt callback (6 bytes <= TIMER_DELEGATE_CONTEXT_SIZE), no global needed
+void TimerHandler(pinStruct outputPins);
 
 #endif      // Argument_Complex_Multi_h
@@ -32,7 +32,7 @@
 // To be included only in main(), .ino with setup() to avoid `Multiple Definitions` Linker Error
 #include "TimerInterrupt.h"
 
-volatile pinStruct myOutputPins = { LED_BUILTIN, A0, A1 };
+pinStruct myOutputPins = { LED_BUILTIN, A0, A1 };
 
 #define TIMER_INTERVAL_MS    1000
 
@@ -65,7 +65,7 @@ void setup()
 
   // Using ATmega328 used in UNO => 16MHz CPU clock ,
 
-  if (ITimer1.attachInterruptInterval(TIMER_INTERVAL_MS, TimerHandler, (unsigned int) &myOutputPins))
+  if (ITimer1.attachInterruptInterval(TIMER_INTERVAL_MS, TimerHandler, myOutputPins))
   {
     Serial.print(F("Starting  ITimer1 OK, millis() = ")); Serial.println(millis());
   }
@@ -76,7 +76,7 @@ void setup()
 
   ITimer3.init();
 
-  if (ITimer3.attachInterruptInterval(TIMER_INTERVAL_MS, TimerHandler, (unsigned int) &myOutputPins))
+  if (ITimer3.attachInterruptInterval(TIMER_INTERVAL_MS, TimerHandler, myOutputPins))
   {
     Serial.print(F("Starting  ITimer3 OK, millis() = ")); Serial.println(millis());
   }
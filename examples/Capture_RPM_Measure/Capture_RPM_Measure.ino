@@ -0,0 +1,87 @@
+/****************************************************************************************************************************
+  Capture_RPM_Measure.ino
+  For Arduino and Adadruit AVR 328(P) and 32u4 boards
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt
+  Licensed under MIT license
+
+  Same RPM measurement as RPM_Measure, with the Input Capture unit of a 16-bit timer instead of a 1ms timer ISR.
+  The hardware latches the timer count on each falling edge of the ICPn pin, so the rotation time has the resolution
+  of the timer clock, 4us here, with only one interrupt per rotation instead of 1000 interrupts per second.
+ *****************************************************************************************************************************/
+/* One rotation is detected by a falling edge of a magnetic REED SW or IR LED Sensor on the ICPn pin.
+   The noise canceler filters glitches shorter than 4 CPU cycles, and rotations faster than MIN_ROTATION_US are
+   considered as bounces.
+   RPM = 60000000 / (rotation time in us)
+*/
+
+// These define's must be placed at the beginning before #include "TimerCapture.h"
+#if ( defined(__AVR_ATmega1280__) || defined(__AVR_ATmega2560__) )
+  // ICP1 isn't wired on Mega, ICP5 is pin 48
+  #define USE_TIMER_CAPTURE_5     true
+  #define CAPTURE_TIMER_NO        5
+  #define CAPTURE_PIN             48
+  #warning Using Timer5, ICP5
+#elif ( defined(__AVR_ATmega32U4__) )
+  #define USE_TIMER_CAPTURE_1     true
+  #define CAPTURE_TIMER_NO        1
+  #define CAPTURE_PIN             4
+  #warning Using Timer1, ICP1
+#else
+  #define USE_TIMER_CAPTURE_1     true
+  #define CAPTURE_TIMER_NO        1
+  #define CAPTURE_PIN             8
+  #warning Using Timer1, ICP1
+#endif
+
+// To be included only in main(), .ino with setup() to avoid `Multiple Definitions` Linker Error
+#include "TimerCapture.h"
+
+typedef TimerCapture<CAPTURE_TIMER_NO> RotationCapture;
+
+// Max speed is 600RPM => 10 RPS => minimum 100ms a rotation. Faster is bouncing
+#define MIN_ROTATION_US         80000UL
+
+float RPM       = 0.00;
+float avgRPM    = 0.00;
+
+void setup()
+{
+  pinMode(CAPTURE_PIN, INPUT_PULLUP);
+
+  Serial.begin(115200);
+  while (!Serial);
+
+  Serial.print(F("\nStarting Capture_RPM_Measure on "));
+  Serial.println(BOARD_TYPE);
+  Serial.println(TIMER_INTERRUPT_VERSION);
+  Serial.print(F("CPU Frequency = ")); Serial.print(F_CPU / 1000000); Serial.println(F(" MHz"));
+
+  // Timer clock F_CPU / 64, 4us at 16MHz. The 32-bit extended count measures rotations up to 4.7 hours
+  if (RotationCapture::begin(CAPTURE_FALLING, true, PRESCALER_64))
+  {
+    Serial.print(F("Starting Timer")); Serial.print(CAPTURE_TIMER_NO);
+    Serial.print(F(" capture on pin ")); Serial.println(CAPTURE_PIN);
+  }
+  else
+    Serial.println(F("Can't set capture. Select another Timer or prescaler"));
+}
+
+void loop()
+{
+  if (RotationCapture::available())
+  {
+    uint32_t rotationUs = RotationCapture::getPeriodMicros();
+
+    if (rotationUs >= MIN_ROTATION_US)
+    {
+      RPM = 60000000.0f / rotationUs;
+
+      avgRPM = ( 2 * avgRPM + RPM) / 3;
+
+      Serial.print(F("RPM = ")); Serial.print(avgRPM);
+      Serial.print(F(", rotationTime us = ")); Serial.println(rotationUs);
+    }
+  }
+}
@@ -182,19 +182,19 @@ void loop()
       //setInterval(unsigned long interval, timerCallback callback)
       multFactor = (multFactor + 1) % 2;
 
-      // interval (in ms) and duration (in milliseconds). Duration = 0 or not specified => run indefinitely
-      // bool setInterval(unsigned long interval, timer_callback callback, unsigned long duration)
+      // New period (in us), applied by the ISR at the end of the running one, without any cut or doubled period
+      // bool setPeriodAsync(unsigned long periodMicros)
       
-      ITimer1.setInterval(TIMER1_INTERVAL_MS * (multFactor + 1), TimerHandler1);
+      ITimer1.setPeriodAsync(TIMER1_INTERVAL_MS * (multFactor + 1) * 1000UL);
 
       Serial.print(F("Changing Interval, Timer1 = ")); Serial.println(TIMER1_INTERVAL_MS * (multFactor + 1)); 
 
 #if USE_TIMER_2
-      ITimer2.setInterval(TIMER_INTERVAL_MS * (multFactor + 1), TimerHandler);
+      ITimer2.setPeriodAsync(TIMER_INTERVAL_MS * (multFactor + 1) * 1000UL);
 
       Serial.print(F("Changing Interval, Timer2 = ")); Serial.println(TIMER_INTERVAL_MS * (multFactor + 1));  
 #elif USE_TIMER_3
-      ITimer3.setInterval(TIMER_INTERVAL_MS * (multFactor + 1), TimerHandler);
+      ITimer3.setPeriodAsync(TIMER_INTERVAL_MS * (multFactor + 1) * 1000UL);
 
       Serial.print(F("Changing Interval, Timer3 = ")); Serial.println(TIMER_INTERVAL_MS * (multFactor + 1));                            
 #endif
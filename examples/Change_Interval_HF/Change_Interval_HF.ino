@@ -139,6 +139,10 @@ void setup()
 
   ITimer2.init();
 
+  // 8-bit Timer2 has coarse OCR steps at high frequencies, such as 1000 / 3 Hz. Alternate OCR and OCR + 1
+  // so that the average frequency is exact, with a jitter of one count, at most 8 CPU cycles
+  ITimer2.setDithering(true, 8);
+
   if (ITimer2.attachInterrupt(TIMER_FREQUENCY, TimerHandler))
   {
     Serial.print(F("Starting  ITimer2 OK, millis() = ")); Serial.println(millis());
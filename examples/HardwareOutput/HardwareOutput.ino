@@ -0,0 +1,74 @@
+/****************************************************************************************************************************
+  HardwareOutput.ino
+  For Arduino and Adadruit AVR 328(P) and 32u4 boards
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt
+  Licensed under MIT license
+
+  attachOutput() lets Timer1 toggle its OC1A pin by hardware on each compare, so the square wave costs no interrupt
+  nor digitalWrite(), and can go up to F_CPU / 2, far beyond what an ISR can toggle.
+  Every 10s, the output frequency steps through OUTPUT_FREQUENCIES.
+ *****************************************************************************************************************************/
+
+// These define's must be placed at the beginning before #include "TimerInterrupt.h"
+// _TIMERINTERRUPT_LOGLEVEL_ from 0 to 4
+// Don't define _TIMERINTERRUPT_LOGLEVEL_ > 0. Only for special ISR debugging only. Can hang the system.
+#define TIMER_INTERRUPT_DEBUG         0
+#define _TIMERINTERRUPT_LOGLEVEL_     0
+
+#define USE_TIMER_1     true
+
+// To be included only in main(), .ino with setup() to avoid `Multiple Definitions` Linker Error
+#include "TimerInterrupt.h"
+
+// OC1A pin
+#if ( defined(__AVR_ATmega1280__) || defined(__AVR_ATmega2560__) )
+  #define OUTPUT_PIN      11
+#else
+  #define OUTPUT_PIN      9
+#endif
+
+const float OUTPUT_FREQUENCIES[] = { 1.0f, 440.0f, 38000.0f, 1000000.0f, 8000000.0f };
+
+#define NUMBER_OUTPUT_FREQUENCIES     ( sizeof(OUTPUT_FREQUENCIES) / sizeof(OUTPUT_FREQUENCIES[0]) )
+
+void startOutput(uint8_t index)
+{
+  Serial.print(F("Output on pin ")); Serial.print(OUTPUT_PIN);
+  Serial.print(F(", frequency = ")); Serial.print(OUTPUT_FREQUENCIES[index]);
+
+  if (ITimer1.attachOutput(OUTPUT_FREQUENCIES[index], OUTPUT_PIN))
+  {
+    // The compare rate is twice the output frequency
+    Serial.print(F(" Hz, actual = ")); Serial.println(ITimer1.getActualFrequency() / 2);
+  }
+  else
+    Serial.println(F(" Hz, failed. Check OUTPUT_PIN is OC1A"));
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  while (!Serial);
+
+  Serial.print(F("\nStarting HardwareOutput on "));
+  Serial.println(BOARD_TYPE);
+  Serial.println(TIMER_INTERRUPT_VERSION);
+  Serial.print(F("CPU Frequency = ")); Serial.print(F_CPU / 1000000); Serial.println(F(" MHz"));
+
+  ITimer1.init();
+
+  startOutput(0);
+}
+
+void loop()
+{
+  static uint8_t index = 0;
+
+  delay(10000);
+
+  index = (index + 1) % NUMBER_OUTPUT_FREQUENCIES;
+
+  startOutput(index);
+}
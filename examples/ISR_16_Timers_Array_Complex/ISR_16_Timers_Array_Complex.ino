@@ -341,6 +341,10 @@ void setup()
   //ISR_timer.setInterval(2000L, doingSomething2s);
   //ISR_timer.setInterval(5000L, doingSomething5s);
 
+  // Give each timer the phase making it run in the same tick as the fewest others,
+  // instead of all of them in the same ISR every lcm of their intervals
+  ISR_timer.setAutoSpread(true, TIMER_INTERVAL_MS);
+
   // Just to demonstrate, don't use too many ISR Timers if not absolutely necessary
   // You can use up to 16 timer for each ISR_Timer
   for (uint16_t i = 0; i < NUMBER_ISR_TIMERS; i++)
@@ -354,6 +358,8 @@ void setup()
 #endif    
   }
 
+  Serial.print(F("Max ISR_Timer callbacks per tick = ")); Serial.println(ISR_timer.getMaxCallbacksPerTick(TIMER_INTERVAL_MS));
+
   // You need this timer for non-critical tasks. Avoid abusing ISR if not absolutely necessary.
   simpleTimer.setInterval(SIMPLE_TIMER_MS, simpleTimerDoingSomething2s);
 }
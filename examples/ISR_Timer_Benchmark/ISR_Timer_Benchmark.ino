@@ -0,0 +1,170 @@
+/****************************************************************************************************************************
+  ISR_Timer_Benchmark.ino
+  For Arduino and Adadruit AVR 328(P) and 32u4 boards
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt
+  Licensed under MIT license
+
+  Now we can use these new 16 ISR-based timers, while consuming only 1 hardware Timer.
+  Their independently-selected, maximum interval is practically unlimited (limited only by unsigned long miliseconds)
+  The accuracy is nearly perfect compared to software timers. The most important feature is they're ISR-based timers
+  Therefore, their executions are not blocked by bad-behaving functions / tasks.
+  This important feature is absolutely necessary for mission-critical tasks.
+
+  This example measures the CPU cycles spent in each ISR_Timer.run() call, i.e. the cost added to every hardware
+  timer tick, with 1, 8 and 16 active ISR-based timers. Most ticks have nothing due, so this is the number that
+  decides how short the hardware timer interval can be.
+  Build it once as is, then once with ISR_TIMER_LINEAR_SCAN true, for the baseline of run() checking all the slots on
+  every tick, so that both numbers come from the same sketch and board.
+  Then the same for ISR_TimerWheel.run() with up to ISR_TIMER_WHEEL_MAX_TIMERS timers, to show its flat per-tick cost.
+*****************************************************************************************************************************/
+
+// These define's must be placed at the beginning before #include "TimerInterrupt.h"
+// _TIMERINTERRUPT_LOGLEVEL_ from 0 to 4
+// Don't define _TIMERINTERRUPT_LOGLEVEL_ > 0. Only for special ISR debugging only. Can hang the system.
+#define TIMER_INTERRUPT_DEBUG         0
+#define _TIMERINTERRUPT_LOGLEVEL_     0
+
+// true for the baseline linear scan of all the slots in ISR_Timer.run(), false for the deadline heap
+#define ISR_TIMER_LINEAR_SCAN   false
+
+// No hardware timer is needed here, ISR_Timer.run() is called directly from loop()
+#define USE_TIMER_1     false
+
+// To be included only in main(), .ino with setup() to avoid `Multiple Definitions` Linker Error
+#include "TimerInterrupt.h"
+
+// To be included only in main(), .ino with setup() to avoid `Multiple Definitions` Linker Error
+#include "ISR_Timer.h"
+
+// To be included only in main(), .ino with setup() to avoid `Multiple Definitions` Linker Error
+#include "ISR_TimerWheel.h"
+
+ISR_Timer ISR_timer;
+
+// Each run() call is one 1ms tick
+ISR_TimerWheel ISR_timerWheel(1);
+
+#define NUMBER_RUN_CALLS        10000L
+
+// Long enough so that the timers are practically never due during the measurement
+#define BENCHMARK_INTERVAL_MS   60000L
+
+const uint8_t numActiveTimers[] = { 1, 8, 16 };
+
+const uint8_t numActiveWheelTimers[] = { 1, 8, 16, 32, 64, 128 };
+
+volatile uint32_t callbackCount = 0;
+
+void doingSomething()
+{
+  callbackCount++;
+}
+
+// Return the average number of CPU cycles per ISR_Timer.run() call with numTimers active timers
+uint32_t measureRunCycles(uint8_t numTimers)
+{
+  int timerId[ISR_Timer::MAX_TIMERS];
+
+  for (uint8_t i = 0; i < numTimers; i++)
+  {
+    // Different intervals, to have the timers spread over the whole schedule
+    timerId[i] = ISR_timer.setInterval(BENCHMARK_INTERVAL_MS + i * 1000L, doingSomething);
+  }
+
+  uint32_t startMicros = micros();
+
+  for (uint32_t i = 0; i < NUMBER_RUN_CALLS; i++)
+  {
+    ISR_timer.run();
+  }
+
+  uint32_t elapsedMicros = micros() - startMicros;
+
+  for (uint8_t i = 0; i < numTimers; i++)
+  {
+    ISR_timer.deleteTimer(timerId[i]);
+  }
+
+  return (elapsedMicros * clockCyclesPerMicrosecond()) / NUMBER_RUN_CALLS;
+}
+
+// Return the average number of CPU cycles per ISR_TimerWheel.run() call, i.e. per tick, with numTimers active timers
+uint32_t measureWheelRunCycles(uint8_t numTimers)
+{
+  int timerId[ISR_TimerWheel::MAX_TIMERS];
+
+  for (uint8_t i = 0; i < numTimers; i++)
+  {
+    // Periods spread from 1s to 128s, so that timers are due and cascaded during the measurement
+    timerId[i] = ISR_timerWheel.setInterval(1000L + i * 1000L, doingSomething);
+  }
+
+  uint32_t startMicros = micros();
+
+  for (uint32_t i = 0; i < NUMBER_RUN_CALLS; i++)
+  {
+    ISR_timerWheel.run();
+  }
+
+  uint32_t elapsedMicros = micros() - startMicros;
+
+  for (uint8_t i = 0; i < numTimers; i++)
+  {
+    ISR_timerWheel.deleteTimer(timerId[i]);
+  }
+
+  return (elapsedMicros * clockCyclesPerMicrosecond()) / NUMBER_RUN_CALLS;
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  while (!Serial);
+
+  Serial.print(F("\nStarting ISR_Timer_Benchmark on "));
+  Serial.println(BOARD_TYPE);
+  Serial.println(TIMER_INTERRUPT_VERSION);
+  Serial.print(F("CPU Frequency = ")); Serial.print(F_CPU / 1000000); Serial.println(F(" MHz"));
+
+  ISR_timer.init();
+
+#if ISR_TIMER_LINEAR_SCAN
+  Serial.println(F("ISR_Timer.run() : linear scan of all the slots (baseline)"));
+#else
+  Serial.println(F("ISR_Timer.run() : deadline heap"));
+#endif
+
+  for (uint8_t i = 0; i < sizeof(numActiveTimers); i++)
+  {
+    Serial.print(F("Active timers = ")); Serial.print(numActiveTimers[i]);
+    Serial.print(F(", cycles per run() = ")); Serial.println(measureRunCycles(numActiveTimers[i]));
+  }
+
+  ISR_timerWheel.init();
+
+  for (uint8_t i = 0; i < sizeof(numActiveWheelTimers); i++)
+  {
+    if (numActiveWheelTimers[i] > ISR_TimerWheel::MAX_TIMERS)
+      break;
+
+    Serial.print(F("Wheel timers = ")); Serial.print(numActiveWheelTimers[i]);
+    Serial.print(F(", cycles per run() = ")); Serial.println(measureWheelRunCycles(numActiveWheelTimers[i]));
+  }
+
+  // Includes the loop and micros() overhead, to be deducted from the numbers above
+  uint32_t startMicros = micros();
+
+  for (uint32_t i = 0; i < NUMBER_RUN_CALLS; i++)
+  {
+    __asm__ __volatile__ ("nop");
+  }
+
+  Serial.print(F("Loop overhead, cycles per call = "));
+  Serial.println(((micros() - startMicros) * clockCyclesPerMicrosecond()) / NUMBER_RUN_CALLS);
+}
+
+void loop()
+{
+}
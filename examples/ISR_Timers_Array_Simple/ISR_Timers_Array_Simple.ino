@@ -50,7 +50,8 @@
 
 #include <SimpleTimer.h>              // https://github.com/schinken/SimpleTimer
 
-ISR_Timer ISR_timer;
+// Only 2 ISR-based timers are used here, no need to reserve RAM for the 16 ones of ISR_Timer
+ISR_TimerN<2> ISR_timer;
 
 #ifndef LED_BUILTIN
   #define LED_BUILTIN       13
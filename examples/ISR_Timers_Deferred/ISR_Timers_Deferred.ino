@@ -0,0 +1,148 @@
+/****************************************************************************************************************************
+  ISR_Timers_Deferred.ino
+  For Arduino and Adadruit AVR 328(P) and 32u4 boards
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt
+  Licensed under MIT license
+
+  Now we can use these new 16 ISR-based timers, while consuming only 1 hardware Timer.
+  Their independently-selected, maximum interval is practically unlimited (limited only by unsigned long miliseconds)
+  The accuracy is nearly perfect compared to software timers. The most important feature is they're ISR-based timers
+  Therefore, their executions are not blocked by bad-behaving functions / tasks.
+  This important feature is absolutely necessary for mission-critical tasks.
+
+  A slow callback in the ISR delays every other interrupt of the system. In deferred mode, the ISR only queues the
+  due timer, and its callback is called later from loop() by drain(), within a time budget. The ISR time stays
+  the same however long the callback is.
+*****************************************************************************************************************************/
+
+// These define's must be placed at the beginning before #include "TimerInterrupt.h"
+// _TIMERINTERRUPT_LOGLEVEL_ from 0 to 4
+// Don't define _TIMERINTERRUPT_LOGLEVEL_ > 0. Only for special ISR debugging only. Can hang the system.
+#define TIMER_INTERRUPT_DEBUG         0
+#define _TIMERINTERRUPT_LOGLEVEL_     0
+
+#if ( defined(__AVR_ATmega644__) || defined(__AVR_ATmega644A__) || defined(__AVR_ATmega644P__) || defined(__AVR_ATmega644PA__)  || \
+        defined(ARDUINO_AVR_UNO) || defined(ARDUINO_AVR_NANO) || defined(ARDUINO_AVR_MINI) ||    defined(ARDUINO_AVR_ETHERNET) || \
+        defined(ARDUINO_AVR_FIO) || defined(ARDUINO_AVR_BT)   || defined(ARDUINO_AVR_LILYPAD) || defined(ARDUINO_AVR_PRO)      || \
+        defined(ARDUINO_AVR_NG) || defined(ARDUINO_AVR_UNO_WIFI_DEV_ED) || defined(ARDUINO_AVR_DUEMILANOVE) || defined(ARDUINO_AVR_FEATHER328P) || \
+        defined(ARDUINO_AVR_METRO) || defined(ARDUINO_AVR_PROTRINKET5) || defined(ARDUINO_AVR_PROTRINKET3) || defined(ARDUINO_AVR_PROTRINKET5FTDI) || \
+        defined(ARDUINO_AVR_PROTRINKET3FTDI) )
+  #define USE_TIMER_1     true
+  #warning Using Timer1
+#else          
+  #define USE_TIMER_3     true
+  #warning Using Timer3
+#endif
+
+// To be included only in main(), .ino with setup() to avoid `Multiple Definitions` Linker Error
+#include "TimerInterrupt.h"
+
+// drain() and setDeferred(), off by default to save RAM
+#define ISR_TIMER_DEFERRED            true
+
+// To be included only in main(), .ino with setup() to avoid `Multiple Definitions` Linker Error
+#include "ISR_Timer.h"
+
+ISR_TimerN<2> ISR_timer;
+
+#define TIMER_INTERVAL_MS            1L
+
+// Time budget of drain() in each loop()
+#define DRAIN_BUDGET_US              2000L
+
+volatile uint32_t maxISRMicros  = 0;
+
+volatile uint32_t numFastCalls  = 0;
+uint32_t          numSlowCalls  = 0;
+
+void TimerHandler()
+{
+  uint32_t start = micros();
+
+  ISR_timer.run();
+
+  uint32_t duration = micros() - start;
+
+  if (duration > maxISRMicros)
+    maxISRMicros = duration;
+}
+
+// Called in the ISR
+void doingSomethingFast()
+{
+  numFastCalls++;
+}
+
+// Called from loop(), by drain()
+void doingSomethingSlow()
+{
+  // Simulate a long computation, such as updating a display
+  delayMicroseconds(5000);
+
+  numSlowCalls++;
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  while (!Serial);
+
+  Serial.print(F("\nStarting ISR_Timers_Deferred on "));
+  Serial.println(BOARD_TYPE);
+  Serial.println(TIMER_INTERRUPT_VERSION);
+  Serial.print(F("CPU Frequency = ")); Serial.print(F_CPU / 1000000); Serial.println(F(" MHz"));
+
+#if USE_TIMER_1
+
+  ITimer1.init();
+
+  if (ITimer1.attachInterruptInterval(TIMER_INTERVAL_MS, TimerHandler))
+  {
+    Serial.print(F("Starting  ITimer1 OK, millis() = ")); Serial.println(millis());
+  }
+  else
+    Serial.println(F("Can't set ITimer1. Select another freq. or timer"));
+
+#elif USE_TIMER_3
+
+  ITimer3.init();
+
+  if (ITimer3.attachInterruptInterval(TIMER_INTERVAL_MS, TimerHandler))
+  {
+    Serial.print(F("Starting  ITimer3 OK, millis() = ")); Serial.println(millis());
+  }
+  else
+    Serial.println(F("Can't set ITimer3. Select another freq. or timer"));
+
+#endif
+
+  ISR_timer.setInterval(10L, doingSomethingFast);
+
+  int slowTimer = ISR_timer.setInterval(100L, doingSomethingSlow);
+
+  // Without this, the 5ms callback would run in the ISR, and maxISRMicros would be over 5000us
+  ISR_timer.setDeferred(slowTimer);
+}
+
+void loop()
+{
+  static unsigned long lastPrint = 0;
+
+  ISR_timer.drain(DRAIN_BUDGET_US);
+
+  if (millis() - lastPrint >= 10000)
+  {
+    lastPrint = millis();
+
+    // Expected 1000 fast and 100 slow calls per 10s, with a max ISR time of a few tens of us
+    Serial.print(F("Fast calls : ")); Serial.print(numFastCalls);
+    Serial.print(F(", Slow calls : ")); Serial.print(numSlowCalls);
+    Serial.print(F(", Max ISR time (us) : ")); Serial.println(maxISRMicros);
+
+    numFastCalls  = 0;
+    numSlowCalls  = 0;
+    maxISRMicros  = 0;
+  }
+}
@@ -0,0 +1,161 @@
+/****************************************************************************************************************************
+  ISR_Timers_Micros.ino
+  For Arduino and Adadruit AVR 328(P) and 32u4 boards
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt
+  Licensed under MIT license
+
+  Now we can use these new 16 ISR-based timers, while consuming only 1 hardware Timer.
+  Their independently-selected, maximum interval is practically unlimited (limited only by unsigned long miliseconds)
+  The accuracy is nearly perfect compared to software timers. The most important feature is they're ISR-based timers
+  Therefore, their executions are not blocked by bad-behaving functions / tasks.
+  This important feature is absolutely necessary for mission-critical tasks.
+
+  With TIMER_INTERRUPT_TIME_BASE, the hardware timer keeps its own us time base, extended by its counter.
+  ISR_TimerN uses it instead of millis(), so intervals are in microseconds, and in tickless mode each ISR-based timer
+  interrupts exactly when due, with the resolution of the timer prescaler instead of the 1ms millis() tick.
+*****************************************************************************************************************************/
+
+// These define's must be placed at the beginning before #include "TimerInterrupt.h"
+// _TIMERINTERRUPT_LOGLEVEL_ from 0 to 4
+// Don't define _TIMERINTERRUPT_LOGLEVEL_ > 0. Only for special ISR debugging only. Can hang the system.
+#define TIMER_INTERRUPT_DEBUG         0
+#define _TIMERINTERRUPT_LOGLEVEL_     0
+
+// Keep the us time base for ITimerX.getMicros()
+#define TIMER_INTERRUPT_TIME_BASE     true
+
+#if ( defined(__AVR_ATmega644__) || defined(__AVR_ATmega644A__) || defined(__AVR_ATmega644P__) || defined(__AVR_ATmega644PA__)  || \
+        defined(ARDUINO_AVR_UNO) || defined(ARDUINO_AVR_NANO) || defined(ARDUINO_AVR_MINI) ||    defined(ARDUINO_AVR_ETHERNET) || \
+        defined(ARDUINO_AVR_FIO) || defined(ARDUINO_AVR_BT)   || defined(ARDUINO_AVR_LILYPAD) || defined(ARDUINO_AVR_PRO)      || \
+        defined(ARDUINO_AVR_NG) || defined(ARDUINO_AVR_UNO_WIFI_DEV_ED) || defined(ARDUINO_AVR_DUEMILANOVE) || defined(ARDUINO_AVR_FEATHER328P) || \
+        defined(ARDUINO_AVR_METRO) || defined(ARDUINO_AVR_PROTRINKET5) || defined(ARDUINO_AVR_PROTRINKET3) || defined(ARDUINO_AVR_PROTRINKET5FTDI) || \
+        defined(ARDUINO_AVR_PROTRINKET3FTDI) )
+  #define USE_TIMER_1     true
+  #warning Using Timer1
+#else          
+  #define USE_TIMER_3     true
+  #warning Using Timer3
+#endif
+
+// To be included only in main(), .ino with setup() to avoid `Multiple Definitions` Linker Error
+#include "TimerInterrupt.h"
+
+// To be included only in main(), .ino with setup() to avoid `Multiple Definitions` Linker Error
+#include "ISR_Timer.h"
+
+// Time base of ISR_timer, in us
+unsigned long timerMicros()
+{
+#if USE_TIMER_1
+  return ITimer1.getMicros();
+#elif USE_TIMER_3
+  return ITimer3.getMicros();
+#endif
+}
+
+ISR_TimerN<2, timerMicros> ISR_timer;
+
+// Only used until the first ISR_Timer deadline is programmed
+#define TIMER_INTERVAL_MS            1L
+
+#define TIMER_250US                  250L
+#define TIMER_1300US                 1300L
+
+volatile uint32_t numInterrupts = 0;
+
+volatile uint32_t deltaMicros250us  = 0;
+volatile uint32_t deltaMicros1300us = 0;
+
+volatile uint32_t previousMicros250us  = 0;
+volatile uint32_t previousMicros1300us = 0;
+
+void TimerHandler()
+{
+  numInterrupts++;
+
+  ISR_timer.run();
+}
+
+// Called by ISR_timer with the interval until the next due timer
+void setNextTimerInterrupt(unsigned long interval)
+{
+#if USE_TIMER_1
+  ITimer1.setNextIntervalMicros(interval);
+#elif USE_TIMER_3
+  ITimer3.setNextIntervalMicros(interval);
+#endif
+}
+
+void doingSomething250us()
+{
+  unsigned long currentMicros = timerMicros();
+
+  deltaMicros250us    = currentMicros - previousMicros250us;
+  previousMicros250us = currentMicros;
+}
+
+void doingSomething1300us()
+{
+  unsigned long currentMicros = timerMicros();
+
+  deltaMicros1300us    = currentMicros - previousMicros1300us;
+  previousMicros1300us = currentMicros;
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  while (!Serial);
+
+  Serial.print(F("\nStarting ISR_Timers_Micros on "));
+  Serial.println(BOARD_TYPE);
+  Serial.println(TIMER_INTERRUPT_VERSION);
+  Serial.print(F("CPU Frequency = ")); Serial.print(F_CPU / 1000000); Serial.println(F(" MHz"));
+
+#if USE_TIMER_1
+
+  ITimer1.init();
+
+  if (ITimer1.attachInterruptInterval(TIMER_INTERVAL_MS, TimerHandler))
+  {
+    Serial.print(F("Starting  ITimer1 OK, millis() = ")); Serial.println(millis());
+  }
+  else
+    Serial.println(F("Can't set ITimer1. Select another freq. or timer"));
+
+#elif USE_TIMER_3
+
+  ITimer3.init();
+
+  if (ITimer3.attachInterruptInterval(TIMER_INTERVAL_MS, TimerHandler))
+  {
+    Serial.print(F("Starting  ITimer3 OK, millis() = ")); Serial.println(millis());
+  }
+  else
+    Serial.println(F("Can't set ITimer3. Select another freq. or timer"));
+
+#endif
+
+  ISR_timer.setInterval(TIMER_250US,  doingSomething250us);
+  ISR_timer.setInterval(TIMER_1300US, doingSomething1300us);
+
+  // From now on, the hardware timer only interrupts when one of the ISR-based timers is due
+  ISR_timer.setTickless(setNextTimerInterrupt);
+}
+
+void loop()
+{
+  static uint32_t lastNumInterrupts = 0;
+
+  delay(10000);
+
+  uint32_t interrupts10s = numInterrupts - lastNumInterrupts;
+  lastNumInterrupts += interrupts10s;
+
+  // Expected 250us and 1300us, with around 47700 interrupts per 10s, one per ISR-based timer expiry
+  Serial.print(F("Timer250us actual : ")); Serial.print(deltaMicros250us);
+  Serial.print(F(", Timer1300us actual : ")); Serial.print(deltaMicros1300us);
+  Serial.print(F(", Interrupts in 10s : ")); Serial.println(interrupts10s);
+}
@@ -0,0 +1,145 @@
+/****************************************************************************************************************************
+  ISR_Timers_Tickless.ino
+  For Arduino and Adadruit AVR 328(P) and 32u4 boards
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt
+  Licensed under MIT license
+
+  Now we can use these new 16 ISR-based timers, while consuming only 1 hardware Timer.
+  Their independently-selected, maximum interval is practically unlimited (limited only by unsigned long miliseconds)
+  The accuracy is nearly perfect compared to software timers. The most important feature is they're ISR-based timers
+  Therefore, their executions are not blocked by bad-behaving functions / tasks.
+  This important feature is absolutely necessary for mission-critical tasks.
+
+  In tickless mode, the hardware timer doesn't interrupt every 1ms any more. ISR_Timer reprograms it to interrupt
+  exactly at the next due ISR-based timer, so there's about one interrupt per timer expiry, instead of 1000 per second.
+*****************************************************************************************************************************/
+
+// These define's must be placed at the beginning before #include "TimerInterrupt.h"
+// _TIMERINTERRUPT_LOGLEVEL_ from 0 to 4
+// Don't define _TIMERINTERRUPT_LOGLEVEL_ > 0. Only for special ISR debugging only. Can hang the system.
+#define TIMER_INTERRUPT_DEBUG         0
+#define _TIMERINTERRUPT_LOGLEVEL_     0
+
+#if ( defined(__AVR_ATmega644__) || defined(__AVR_ATmega644A__) || defined(__AVR_ATmega644P__) || defined(__AVR_ATmega644PA__)  || \
+        defined(ARDUINO_AVR_UNO) || defined(ARDUINO_AVR_NANO) || defined(ARDUINO_AVR_MINI) ||    defined(ARDUINO_AVR_ETHERNET) || \
+        defined(ARDUINO_AVR_FIO) || defined(ARDUINO_AVR_BT)   || defined(ARDUINO_AVR_LILYPAD) || defined(ARDUINO_AVR_PRO)      || \
+        defined(ARDUINO_AVR_NG) || defined(ARDUINO_AVR_UNO_WIFI_DEV_ED) || defined(ARDUINO_AVR_DUEMILANOVE) || defined(ARDUINO_AVR_FEATHER328P) || \
+        defined(ARDUINO_AVR_METRO) || defined(ARDUINO_AVR_PROTRINKET5) || defined(ARDUINO_AVR_PROTRINKET3) || defined(ARDUINO_AVR_PROTRINKET5FTDI) || \
+        defined(ARDUINO_AVR_PROTRINKET3FTDI) )
+  #define USE_TIMER_1     true
+  #warning Using Timer1
+#else          
+  #define USE_TIMER_3     true
+  #warning Using Timer3
+#endif
+
+// To be included only in main(), .ino with setup() to avoid `Multiple Definitions` Linker Error
+#include "TimerInterrupt.h"
+
+// To be included only in main(), .ino with setup() to avoid `Multiple Definitions` Linker Error
+#include "ISR_Timer.h"
+
+ISR_TimerN<2> ISR_timer;
+
+// Only used until the first ISR_Timer deadline is programmed
+#define TIMER_INTERVAL_MS            1L
+
+volatile uint32_t numInterrupts = 0;
+
+volatile uint32_t deltaMillis2s = 0;
+volatile uint32_t deltaMillis5s = 0;
+
+volatile uint32_t previousMillis2s = 0;
+volatile uint32_t previousMillis5s = 0;
+
+void TimerHandler()
+{
+  numInterrupts++;
+
+  ISR_timer.run();
+}
+
+// Called by ISR_timer with the interval until the next due timer
+void setNextTimerInterrupt(unsigned long interval)
+{
+#if USE_TIMER_1
+  ITimer1.setNextInterval(interval);
+#elif USE_TIMER_3
+  ITimer3.setNextInterval(interval);
+#endif
+}
+
+void doingSomething2s()
+{
+  unsigned long currentMillis  = millis();
+
+  deltaMillis2s    = currentMillis - previousMillis2s;
+  previousMillis2s = currentMillis;
+}
+
+void doingSomething5s()
+{
+  unsigned long currentMillis  = millis();
+
+  deltaMillis5s    = currentMillis - previousMillis5s;
+  previousMillis5s = currentMillis;
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  while (!Serial);
+
+  Serial.print(F("\nStarting ISR_Timers_Tickless on "));
+  Serial.println(BOARD_TYPE);
+  Serial.println(TIMER_INTERRUPT_VERSION);
+  Serial.print(F("CPU Frequency = ")); Serial.print(F_CPU / 1000000); Serial.println(F(" MHz"));
+
+#if USE_TIMER_1
+
+  ITimer1.init();
+
+  if (ITimer1.attachInterruptInterval(TIMER_INTERVAL_MS, TimerHandler))
+  {
+    Serial.print(F("Starting  ITimer1 OK, millis() = ")); Serial.println(millis());
+  }
+  else
+    Serial.println(F("Can't set ITimer1. Select another freq. or timer"));
+
+#elif USE_TIMER_3
+
+  ITimer3.init();
+
+  if (ITimer3.attachInterruptInterval(TIMER_INTERVAL_MS, TimerHandler))
+  {
+    Serial.print(F("Starting  ITimer3 OK, millis() = ")); Serial.println(millis());
+  }
+  else
+    Serial.println(F("Can't set ITimer3. Select another freq. or timer"));
+
+#endif
+
+  ISR_timer.setInterval(2000L, doingSomething2s);
+  ISR_timer.setInterval(5000L, doingSomething5s);
+
+  // From now on, the hardware timer only interrupts when one of the ISR-based timers is due
+  ISR_timer.setTickless(setNextTimerInterrupt);
+}
+
+void loop()
+{
+  static uint32_t lastNumInterrupts = 0;
+
+  delay(10000);
+
+  uint32_t interrupts10s = numInterrupts - lastNumInterrupts;
+  lastNumInterrupts += interrupts10s;
+
+  // Expected 2s and 5s, with a dozen interrupts per 10s instead of 10000 in fixed 1ms tick mode.
+  // Intervals longer than one compare (4.19s with Timer1 at 16MHz) need an intermediate interrupt
+  Serial.print(F("Timer2s actual : ")); Serial.print(deltaMillis2s);
+  Serial.print(F(", Timer5s actual : ")); Serial.print(deltaMillis5s);
+  Serial.print(F(", Interrupts in 10s : ")); Serial.println(interrupts10s);
+}
@@ -0,0 +1,72 @@
+/****************************************************************************************************************************
+  StaticTimer.ino
+  For Arduino and Adadruit AVR 328(P) and 32u4 boards
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt
+  Licensed under MIT license
+
+  For fixed-rate control loops, StaticTimer computes the prescaler and OCR at compile time, so that starting the
+  timer is only a few register writes, without the setFrequency() search nor its RAM.
+  Change CONTROL_LOOP_HZ to a frequency out of range of Timer1, such as 0 or 10000000, to see the compile-time error.
+ *****************************************************************************************************************************/
+
+// These define's must be placed at the beginning before #include "StaticTimer.h"
+#define USE_STATIC_TIMER_1     true
+
+// To be included only in main(), .ino with setup() to avoid `Multiple Definitions` Linker Error
+#include "StaticTimer.h"
+
+#define CONTROL_LOOP_HZ       10000
+
+typedef StaticTimer<1, CONTROL_LOOP_HZ> ControlTimer;
+
+#ifndef LED_BUILTIN
+  #define LED_BUILTIN   13
+#endif
+
+volatile uint32_t numControlLoops = 0;
+
+void ControlLoop()
+{
+  numControlLoops++;
+
+  // Toggle LED_BUILTIN every 0.5s
+  if ( (numControlLoops % (CONTROL_LOOP_HZ / 2)) == 0 )
+    digitalWrite(LED_BUILTIN, !digitalRead(LED_BUILTIN));
+}
+
+void setup()
+{
+  pinMode(LED_BUILTIN, OUTPUT);
+
+  Serial.begin(115200);
+  while (!Serial);
+
+  Serial.print(F("\nStarting StaticTimer on "));
+  Serial.println(BOARD_TYPE);
+  Serial.println(TIMER_INTERRUPT_VERSION);
+  Serial.print(F("CPU Frequency = ")); Serial.print(F_CPU / 1000000); Serial.println(F(" MHz"));
+
+  Serial.print(F("Computed at compile time : CSx = ")); Serial.print(ControlTimer::PRESCALER_INDEX);
+  Serial.print(F(", OCR1A = ")); Serial.println(ControlTimer::OCR_VALUE);
+
+  ControlTimer::attach(ControlLoop);
+}
+
+void loop()
+{
+  static uint32_t lastNumControlLoops = 0;
+
+  delay(10000);
+
+  uint32_t loops10s;
+
+  noInterrupts();
+  loops10s = numControlLoops - lastNumControlLoops;
+  lastNumControlLoops = numControlLoops;
+  interrupts();
+
+  // Expected CONTROL_LOOP_HZ * 10
+  Serial.print(F("Control loops in 10s : ")); Serial.println(loops10s);
+}
@@ -0,0 +1,92 @@
+/****************************************************************************************************************************
+  TimerChannels.ino
+  For Arduino and Adadruit AVR 328(P) and 32u4 boards
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt
+  Licensed under MIT license
+
+  TimerChannels runs Timer1 free and uses each of its Output Compare units, A, B and C, as an independent timer.
+  Channel A blinks LED_BUILTIN every 0.5s, channel B counts 1ms ticks, and channel C, if any, fires a one-shot 100ms
+  after each print, all hardware-precise with Timer1 only, and Timer2 left free.
+  ATmega328P Timer1 has only channels A and B.
+ *****************************************************************************************************************************/
+
+// These define's must be placed at the beginning before #include "TimerChannels.h"
+#define USE_TIMER_CHANNELS_1     true
+
+// To be included only in main(), .ino with setup() to avoid `Multiple Definitions` Linker Error
+#include "TimerChannels.h"
+
+typedef TimerChannels<1> Timer1Channels;
+
+#ifndef LED_BUILTIN
+  #define LED_BUILTIN   13
+#endif
+
+volatile uint32_t numTicks = 0;
+volatile uint32_t oneShotTick = 0;
+
+void BlinkHandler()
+{
+  digitalWrite(LED_BUILTIN, !digitalRead(LED_BUILTIN));
+}
+
+void TickHandler()
+{
+  numTicks++;
+}
+
+void OneShotHandler()
+{
+  oneShotTick = numTicks;
+}
+
+void setup()
+{
+  pinMode(LED_BUILTIN, OUTPUT);
+
+  Serial.begin(115200);
+  while (!Serial);
+
+  Serial.print(F("\nStarting TimerChannels on "));
+  Serial.println(BOARD_TYPE);
+  Serial.println(TIMER_INTERRUPT_VERSION);
+  Serial.print(F("CPU Frequency = ")); Serial.print(F_CPU / 1000000); Serial.println(F(" MHz"));
+
+  // 4us ticks at 16MHz
+  Timer1Channels::begin(PRESCALER_64);
+
+  Timer1Channels::attachMicros(CHANNEL_A, 500000, BlinkHandler);
+  Timer1Channels::attachMicros(CHANNEL_B, 1000, TickHandler);
+
+  Serial.print(F("Timer1 channels = ")); Serial.println(Timer1Channels::numChannels());
+}
+
+void loop()
+{
+  static uint32_t lastNumTicks = 0;
+
+  delay(1000);
+
+  uint32_t ticks;
+
+  noInterrupts();
+  ticks = numTicks;
+  interrupts();
+
+  // Expected 1000
+  Serial.print(F("1ms ticks in 1s : ")); Serial.print(ticks - lastNumTicks);
+
+  if (Timer1Channels::numChannels() > CHANNEL_C)
+  {
+    // Expected 100
+    Serial.print(F(", last one-shot after : ")); Serial.print(oneShotTick - lastNumTicks); Serial.print(F(" ms"));
+
+    Timer1Channels::attachMicros(CHANNEL_C, 100000, OneShotHandler, true);
+  }
+
+  Serial.println();
+
+  lastNumTicks = ticks;
+}
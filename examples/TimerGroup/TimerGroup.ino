@@ -0,0 +1,118 @@
+/****************************************************************************************************************************
+  TimerGroup.ino
+  For Arduino and Adadruit AVR 328(P) and 32u4 boards
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt
+  Licensed under MIT license
+
+  TimerGroup restarts two timers of the same frequency together, the second one lagging by half a period, so that
+  their interrupts interleave, as for 2-phase interleaved PWM or sampling. The lag measured by micros() is printed
+  every 2s, and stays at PHASE_US, within the resolution of micros() and the ISR latency.
+ *****************************************************************************************************************************/
+
+// These define's must be placed at the beginning before #include "TimerInterrupt.h"
+// _TIMERINTERRUPT_LOGLEVEL_ from 0 to 4
+// Don't define _TIMERINTERRUPT_LOGLEVEL_ > 0. Only for special ISR debugging only. Can hang the system.
+#define TIMER_INTERRUPT_DEBUG         0
+#define _TIMERINTERRUPT_LOGLEVEL_     0
+
+#define USE_TIMER_1     true
+
+#if ( defined(__AVR_ATmega644__) || defined(__AVR_ATmega644A__) || defined(__AVR_ATmega644P__) || defined(__AVR_ATmega644PA__)  || \
+        defined(ARDUINO_AVR_UNO) || defined(ARDUINO_AVR_NANO) || defined(ARDUINO_AVR_MINI) ||    defined(ARDUINO_AVR_ETHERNET) || \
+        defined(ARDUINO_AVR_FIO) || defined(ARDUINO_AVR_BT)   || defined(ARDUINO_AVR_LILYPAD) || defined(ARDUINO_AVR_PRO)      || \
+        defined(ARDUINO_AVR_NG) || defined(ARDUINO_AVR_UNO_WIFI_DEV_ED) || defined(ARDUINO_AVR_DUEMILANOVE) || defined(ARDUINO_AVR_FEATHER328P) || \
+        defined(ARDUINO_AVR_METRO) || defined(ARDUINO_AVR_PROTRINKET5) || defined(ARDUINO_AVR_PROTRINKET3) || defined(ARDUINO_AVR_PROTRINKET5FTDI) || \
+        defined(ARDUINO_AVR_PROTRINKET3FTDI) )
+  #define USE_TIMER_2     true
+  #warning Using Timer1, Timer2
+#else
+  #define USE_TIMER_3     true
+  #warning Using Timer1, Timer3
+#endif
+
+// To be included only in main(), .ino with setup() to avoid `Multiple Definitions` Linker Error
+#include "TimerInterrupt.h"
+#include "TimerGroup.hpp"
+
+#if USE_TIMER_2
+  #define ITimerB         ITimer2
+#else
+  #define ITimerB         ITimer3
+#endif
+
+#define TIMER_FREQ_HZ     500
+
+// Half of the 2000us period
+#define PHASE_US          1000
+
+TimerGroup timerGroup;
+
+volatile uint32_t lastMicrosA = 0;
+volatile uint32_t lastMicrosB = 0;
+
+void TimerHandlerA()
+{
+  lastMicrosA = micros();
+}
+
+void TimerHandlerB()
+{
+  lastMicrosB = micros();
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  while (!Serial);
+
+  Serial.print(F("\nStarting TimerGroup on "));
+  Serial.println(BOARD_TYPE);
+  Serial.println(TIMER_INTERRUPT_VERSION);
+  Serial.print(F("CPU Frequency = ")); Serial.print(F_CPU / 1000000); Serial.println(F(" MHz"));
+
+  ITimer1.init();
+  ITimerB.init();
+
+  if ( !ITimer1.attachInterrupt(TIMER_FREQ_HZ, TimerHandlerA) || !ITimerB.attachInterrupt(TIMER_FREQ_HZ, TimerHandlerB) )
+  {
+    Serial.println(F("Can't set timers. Select another freq. or timer"));
+
+    return;
+  }
+
+  timerGroup.add(ITimer1);
+  timerGroup.add(ITimerB, PHASE_US);
+
+  // Both timers restart from here, ITimerB PHASE_US after ITimer1
+  timerGroup.start();
+
+  Serial.print(F("Timers started, phase = ")); Serial.print(PHASE_US); Serial.println(F(" us"));
+}
+
+void loop()
+{
+  delay(2000);
+
+  // Timers not set
+  if (timerGroup.getNumTimers() == 0)
+    return;
+
+  uint32_t microsA;
+  uint32_t microsB;
+
+  // Wait for the interrupts of ITimerB, so that both times are of the same period
+  while (true)
+  {
+    noInterrupts();
+    microsA = lastMicrosA;
+    microsB = lastMicrosB;
+    interrupts();
+
+    if ( (int32_t) (microsB - microsA) > 0 )
+      break;
+  }
+
+  Serial.print(F("Lag of ITimerB = ")); Serial.print(microsB - microsA); Serial.println(F(" us"));
+}
@@ -166,6 +166,9 @@ void setup()
     Serial.println(F("Can't set ITimer3. Select another freq. or timer"));
     
 #endif
+
+  // Actual frequencies, errors and estimated ISR load of the timers
+  printTimerReport(Serial);
 }
 
 void loop()
@@ -45,312 +45,1439 @@
 
 #include <string.h>
 
-// Select time function:
-//static inline unsigned long elapsed() { return micros(); }
-static inline unsigned long elapsed()
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+ISR_TimerN<NUM_TIMERS, TIME_BASE>::ISR_TimerN()
+  : heapSize (0), freeHead (NO_FREE_SLOT), spreadTick (0), ticklessCallback (NULL), numTimers (-1)
 {
-  return millis();
+#if ISR_TIMER_SLACK
+  numSlackTimers  = 0;
+  wakeupsSaved    = 0;
+#endif
+
+#if ISR_TIMER_DEFERRED
+  deferredHead    = 0;
+  deferredTail    = 0;
+#endif
+
+#if ISR_TIMER_DEADLINE_MISS
+  missCallback    = NULL;
+#endif
 }
 
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+void ISR_TimerN<NUM_TIMERS, TIME_BASE>::init()
+{
+  unsigned long current_millis = TIME_BASE();
+
+  for (uint8_t i = 0; i < MAX_TIMERS; i++)
+  {
+    memset((void*) &timer[i], 0, sizeof (timer_t));
+    callbacks[i]         = TimerDelegate();
+    timer[i].prev_millis = current_millis;
+    timer[i].nextFree    = (i + 1 < MAX_TIMERS) ? i + 1 : NO_FREE_SLOT;
+  }
+
+  // slot 0 first, as with the former linear search
+  freeHead      = 0;
+
+  heapSize      = 0;
+
+#if ISR_TIMER_DEFERRED
+  deferredHead  = 0;
+  deferredTail  = 0;
+#endif
+
+  numTimers     = 0;
+}
+
+/////////////////////////////////////////////////
+
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+bool ISR_TimerN<NUM_TIMERS, TIME_BASE>::deadlineBefore(uint8_t slotA, uint8_t slotB)
+{
+  return (long) (heapDeadline(slotA) - heapDeadline(slotB)) < 0;
+}
+
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+void ISR_TimerN<NUM_TIMERS, TIME_BASE>::heapSwap(uint8_t posA, uint8_t posB)
+{
+  uint8_t slotA = deadlineHeap[posA];
+  uint8_t slotB = deadlineHeap[posB];
+
+  deadlineHeap[posA] = slotB;
+  deadlineHeap[posB] = slotA;
+
+  timer[slotB].heapIndex = posA;
+  timer[slotA].heapIndex = posB;
+}
+
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+void ISR_TimerN<NUM_TIMERS, TIME_BASE>::heapSiftUp(uint8_t pos)
+{
+  while (pos > 0)
+  {
+    uint8_t parent = (pos - 1) / 2;
+
+    if (!deadlineBefore(deadlineHeap[pos], deadlineHeap[parent]))
+      break;
+
+    heapSwap(pos, parent);
+    pos = parent;
+  }
+}
+
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+void ISR_TimerN<NUM_TIMERS, TIME_BASE>::heapSiftDown(uint8_t pos)
+{
+  while (true)
+  {
+    // 16-bit, as 2 * pos + 1 overflows 8 bits from pos = 128 on, with up to 254 timers
+    uint16_t child = 2 * pos + 1;
+
+    if (child >= heapSize)
+      break;
+
+    if ( (child + 1 < heapSize) && deadlineBefore(deadlineHeap[child + 1], deadlineHeap[child]) )
+      child++;
+
+    if (!deadlineBefore(deadlineHeap[child], deadlineHeap[pos]))
+      break;
+
+    heapSwap(pos, child);
+    pos = child;
+  }
+}
+
+#if ISR_TIMER_SLACK
+
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+void ISR_TimerN<NUM_TIMERS, TIME_BASE>::heapRebuild()
+{
+  // bottom-up, from the last parent
+  for (uint8_t pos = heapSize / 2; pos > 0; pos--)
+    heapSiftDown(pos - 1);
+
+  updateNextDeadline();
+}
+
+#endif    // #if ISR_TIMER_SLACK
+
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+void ISR_TimerN<NUM_TIMERS, TIME_BASE>::updateNextDeadline()
+{
+  if (heapSize > 0)
+  {
+    nextDeadline = heapDeadline(deadlineHeap[0]);
+  }
+}
+
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+void ISR_TimerN<NUM_TIMERS, TIME_BASE>::heapInsert(uint8_t slot)
+{
+  uint8_t pos = heapSize++;
+
+  deadlineHeap[pos]     = slot;
+  timer[slot].heapIndex = pos;
+
+  heapSiftUp(pos);
+  updateNextDeadline();
+}
+
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+void ISR_TimerN<NUM_TIMERS, TIME_BASE>::heapRemove(uint8_t slot)
+{
+  uint8_t pos = timer[slot].heapIndex;
+
+  if (pos == NOT_IN_HEAP)
+    return;
+
+  uint8_t last = --heapSize;
+
+  if (pos != last)
+  {
+    uint8_t moved = deadlineHeap[last];
+
+    heapSwap(pos, last);
+
+    // the slot moved into the hole can go either way
+    heapSiftUp(pos);
+    heapSiftDown(timer[moved].heapIndex);
+  }
+
+  timer[slot].heapIndex = NOT_IN_HEAP;
+
+  updateNextDeadline();
+}
+
+// re-position the slot after its prev_millis or delay has changed
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+void ISR_TimerN<NUM_TIMERS, TIME_BASE>::heapUpdate(uint8_t slot)
+{
+  uint8_t pos = timer[slot].heapIndex;
+
+  if (pos == NOT_IN_HEAP)
+    return;
+
+  heapSiftUp(pos);
+  heapSiftDown(timer[slot].heapIndex);
+
+  updateNextDeadline();
+}
+
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+void ISR_TimerN<NUM_TIMERS, TIME_BASE>::reprogramTickless()
+{
+  if (heapSize == 0)
+  {
+    // nothing to wait for
+    (*ticklessCallback)(0);
+    return;
+  }
+
+  long interval = (long) (nextDeadline - TIME_BASE());
+
+  // already due, i.e. a callback took longer than the next interval. Get back as soon as possible
+  (*ticklessCallback)( (interval > 0) ? interval : 1 );
+}
 
-ISR_Timer::ISR_Timer()
-  : numTimers (-1)
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+void ISR_TimerN<NUM_TIMERS, TIME_BASE>::setTickless(timer_tickless_callback f)
 {
+  if (numTimers < 0)
+  {
+    init();
+  }
+
+  ISR_TIMER_ENTER_CRITICAL();
+
+#if ISR_TIMER_SLACK
+  bool isModeChanged = ( (ticklessCallback == NULL) != (f == NULL) );
+#endif
+
+  ticklessCallback = f;
+
+#if ISR_TIMER_SLACK
+  // the slack only delays the deadlines in tickless mode
+  if ( isModeChanged && (numSlackTimers > 0) )
+    heapRebuild();
+#endif
+
+  if (ticklessCallback)
+    reprogramTickless();
+
+  ISR_TIMER_EXIT_CRITICAL();
+}
+
+/////////////////////////////////////////////////
+
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+void ISR_TimerN<NUM_TIMERS, TIME_BASE>::run()
+{
+  uint8_t i;
+  uint8_t numDue = 0;
+  uint8_t dueSlots[MAX_TIMERS];
+  unsigned long current_millis;
+
+  // get current time
+  current_millis = TIME_BASE();
+
+#if ISR_TIMER_LINEAR_SCAN
+
+  // Baseline of ISR_Timer_Benchmark: all the slots are checked on every tick, as before the deadline heap
+  for (i = 0; i < MAX_TIMERS; i++)
+  {
+    // the timers still due after a burst are out of the heap until the end of this run()
+    if ( !callbacks[i].isBound() || (timer[i].heapIndex == NOT_IN_HEAP) )
+      continue;
+
+    if ( (long) (current_millis - heapDeadline(i)) < 0 )
+      continue;
+
+    expireTimer(i, current_millis);
+
+    if (timer[i].toBeCalled != DEFCALL_DONTRUN)
+      dueSlots[numDue++] = i;
+  }
+
+#else
+
+  // nothing is due before the first deadline in the heap
+  if ( (heapSize == 0) || ( (long) (current_millis - nextDeadline) < 0 ) )
+  {
+    // woken up a bit early in tickless mode
+    if (ticklessCallback)
+      reprogramTickless();
+
+    return;
+  }
+
+  // only the due timers are touched: pop them from the top of the heap until the first one in the future
+  while (heapSize > 0)
+  {
+    i = deadlineHeap[0];
+
+    // is it time to process this timer ?
+    // see http://arduino.cc/forum/index.php/topic,124048.msg932592.html#msg932592
+    // signed, as prev_millis is in the future for a timer with a phase
+    if ( (long) (current_millis - heapDeadline(i)) < 0 )
+      break;
+
+    expireTimer(i, current_millis);
+
+    if (timer[i].toBeCalled != DEFCALL_DONTRUN)
+      dueSlots[numDue++] = i;
+  }
+
+#endif    // #if ISR_TIMER_LINEAR_SCAN
+
+#if ISR_TIMER_SLACK
+  // Coalescing, in tickless mode: now that we're awake anyway, also run the timers already due but still within
+  // their slack. Each one saves the wake-up it would have needed later
+  if ( ticklessCallback && (numSlackTimers > 0) )
+  {
+    uint8_t numEarly = 0;
+
+    // collected first, as expireTimer() moves them in the heap
+    for (uint8_t pos = 0; pos < heapSize; pos++)
+    {
+      i = deadlineHeap[pos];
+
+      if ( (long) (current_millis - (timer[i].prev_millis + timer[i].delay)) >= 0 )
+        dueSlots[numDue + numEarly++] = i;
+    }
+
+    for (uint8_t j = 0; j < numEarly; j++)
+    {
+      i = dueSlots[numDue + j];
+
+      expireTimer(i, current_millis);
+
+      // disabled timers don't run, and didn't need a wake-up either
+      if (timer[i].toBeCalled != DEFCALL_DONTRUN)
+      {
+        wakeupsSaved++;
+        dueSlots[numDue++] = i;
+      }
+    }
+  }
+#endif
+
+#if ISR_TIMER_CATCHUP
+  // back in the heap, still due, for the missed runs over the burst cap
+  for (uint8_t j = 0; j < numDue; j++)
+  {
+    i = dueSlots[j];
+
+    if ( (timer[i].heapIndex == NOT_IN_HEAP) && (timer[i].toBeCalled == DEFCALL_RUNONLY) )
+      heapInsert(i);
+  }
+#endif
+
+  updateNextDeadline();
+
+  // The heap pops them by deadline: call them in slot order as before, after the higher priority ones.
+  // Insertion sort, as there are few due timers
+  for (uint8_t j = 1; j < numDue; j++)
+  {
+    i = dueSlots[j];
+
+    uint8_t k = j;
+
+    for ( ; (k > 0) && callBefore(i, dueSlots[k - 1]); k--)
+      dueSlots[k] = dueSlots[k - 1];
+
+    dueSlots[k] = i;
+  }
+
+  for (uint8_t j = 0; j < numDue; j++)
+  {
+    i = dueSlots[j];
+
+    // the timer can have been deleted by a previous callback
+    if (timer[i].toBeCalled == DEFCALL_DONTRUN)
+      continue;
+
+#if ISR_TIMER_DEFERRED
+    if (timer[i].deferred)
+    {
+      // drain() calls it, and deletes it after the last run
+  #if ISR_TIMER_CATCHUP
+      pushDeferred(i, timer[i].toBeCalled, timer[i].missedRuns);
+  #else
+      pushDeferred(i, timer[i].toBeCalled, 0);
+  #endif
+      timer[i].toBeCalled = DEFCALL_DONTRUN;
+
+      continue;
+    }
+#endif
+
+#if ISR_TIMER_DEADLINE_MISS
+    if (timer[i].maxLateness > 0)
+      checkDeadline(i);
+#endif
+
+#if ISR_TIMER_STATS
+    unsigned long latency     = TIME_BASE() - timer[i].prev_millis;
+    unsigned long startMicros = micros();
+#endif
+
+#if ISR_TIMER_CATCHUP
+    // more than once to replay missed runs, unless deleted by its own callback
+    for (uint8_t c = 0; (c < timer[i].numCalls) && (callbacks[i].isBound()); c++)
+      callTimer(i, timer[i].missedRuns);
+#else
+    callTimer(i, 0);
+#endif
+
+#if ISR_TIMER_STATS
+    if (callbacks[i].isBound())
+      updateStats(i, latency, micros() - startMicros);
+#endif
+
+    // deleted by its own callback
+    if (!callbacks[i].isBound())
+      continue;
+
+    if (timer[i].toBeCalled == DEFCALL_RUNANDDEL)
+    {
+      ISR_TIMER_ENTER_CRITICAL();
+
+      deleteSlot(i);
+
+      ISR_TIMER_EXIT_CRITICAL();
+    }
+    else
+      timer[i].toBeCalled = DEFCALL_DONTRUN;
+  }
+
+  if (ticklessCallback)
+    reprogramTickless();
+}
+
+
+// update the due timer in slot and its position in the heap, and set what run() must do with its callback
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+void ISR_TimerN<NUM_TIMERS, TIME_BASE>::expireTimer(uint8_t slot, unsigned long current_millis)
+{
+  timer[slot].toBeCalled  = DEFCALL_DONTRUN;
+
+  // number of intervals elapsed since the last run, more than 1 if run() was called late
+  unsigned long skipTimes = (current_millis - timer[slot].prev_millis) / timer[slot].delay;
+  unsigned long numRuns   = 1;
+
+#if ISR_TIMER_CATCHUP
+  timer[slot].numCalls    = 1;
+  timer[slot].missedRuns  = 0;
+
+  if (timer[slot].enabled)
+  {
+    if (timer[slot].catchUp == CATCHUP_BURST)
+    {
+      // replay the missed runs, but at most burstCap per run()
+      numRuns = min(skipTimes, (unsigned long) timer[slot].burstCap);
+
+      // counted timers don't run more than the remaining number of runs
+      if ( (timer[slot].maxNumRuns != RUN_FOREVER) && (timer[slot].numRuns < timer[slot].maxNumRuns) )
+        numRuns = min(numRuns, (unsigned long) (timer[slot].maxNumRuns - timer[slot].numRuns));
+
+      // update time for the replayed runs only, the next ones are still due
+      skipTimes = numRuns;
+    }
+    else if (timer[slot].catchUp == CATCHUP_COALESCE)
+    {
+      timer[slot].missedRuns = skipTimes - 1;
+    }
+  }
+#endif
+
+  // update time
+  timer[slot].prev_millis += timer[slot].delay * skipTimes;
+
+  // check if the timer callback has to be executed
+  if (timer[slot].enabled)
+  {
+#if ISR_TIMER_CATCHUP
+    timer[slot].numCalls = numRuns;
+#endif
+
+    // "run forever" timers must always be executed
+    if (timer[slot].maxNumRuns == RUN_FOREVER)
+    {
+      timer[slot].toBeCalled = DEFCALL_RUNONLY;
+    }
+    // other timers get executed the specified number of times
+    else if (timer[slot].numRuns < timer[slot].maxNumRuns)
+    {
+      timer[slot].toBeCalled = DEFCALL_RUNONLY;
+      timer[slot].numRuns += numRuns;
+
+      // after the last run, delete the timer
+      if (timer[slot].numRuns >= timer[slot].maxNumRuns)
+      {
+        timer[slot].toBeCalled = DEFCALL_RUNANDDEL;
+      }
+    }
+  }
+
+  if (timer[slot].toBeCalled == DEFCALL_RUNANDDEL)
+  {
+    // won't be due again, deleteSlot() after the callback frees the slot
+    heapRemove(slot);
+  }
+#if ISR_TIMER_CATCHUP
+  else if ( (timer[slot].toBeCalled == DEFCALL_RUNONLY) &&
+            ( (long) (current_millis - (timer[slot].prev_millis + timer[slot].delay)) >= 0 ) )
+  {
+    // still due, with runs over the burst cap. Out of the heap until the end of this run(), not to be popped again
+    heapRemove(slot);
+  }
+#endif
+  else
+  {
+    // new deadline is in the future, move it down the heap
+    heapUpdate(slot);
+  }
+}
+
+#if ISR_TIMER_DEADLINE_MISS
+
+// deadline-miss detection, just before the callback of the due timer in slot is called
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+void ISR_TimerN<NUM_TIMERS, TIME_BASE>::checkDeadline(uint8_t slot)
+{
+  // prev_millis is the deadline of this run
+  unsigned long lateness = TIME_BASE() - timer[slot].prev_millis;
+
+  if (lateness <= timer[slot].maxLateness)
+    return;
+
+  if (timer[slot].deadlineMisses < 0xFFFF)
+    timer[slot].deadlineMisses++;
+
+  if (missCallback)
+    (*missCallback)( (timer[slot].generation << HANDLE_SLOT_BITS) | slot, lateness);
+}
+
+#endif    // #if ISR_TIMER_DEADLINE_MISS
+
+#if ISR_TIMER_STATS
+
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+void ISR_TimerN<NUM_TIMERS, TIME_BASE>::updateStats(uint8_t slot, unsigned long latency, unsigned long execMicros)
+{
+  ISR_TIMER_ENTER_CRITICAL();
+
+  volatile stats_t& stat = stats[slot];
+
+  if ( (stat.numCalls == 0) || (execMicros < stat.minExecMicros) )
+    stat.minExecMicros = execMicros;
+
+  if (execMicros > stat.maxExecMicros)
+    stat.maxExecMicros = execMicros;
+
+  if ( (stat.numCalls == 0) || (latency < stat.minLatency) )
+    stat.minLatency = latency;
+
+  if (latency > stat.maxLatency)
+    stat.maxLatency = latency;
+
+  stat.totalExecMicros  += execMicros;
+  stat.totalLatency     += latency;
+  stat.numCalls++;
+
+  ISR_TIMER_EXIT_CRITICAL();
+}
+
+#endif    // #if ISR_TIMER_STATS
+
+// call the callback of the timer in slot, with its parameter and / or number of missed runs
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+void ISR_TimerN<NUM_TIMERS, TIME_BASE>::callTimer(uint8_t slot, unsigned long missedRuns)
+{
+  callbacks[slot](missedRuns);
+}
+
+#if ISR_TIMER_DEFERRED
+
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+void ISR_TimerN<NUM_TIMERS, TIME_BASE>::pushDeferred(uint8_t slot, uint8_t call, unsigned long missedRuns)
+{
+  // still queued: this run is coalesced into the pending call
+  if (timer[slot].deferredCall != DEFCALL_DONTRUN)
+  {
+#if ISR_TIMER_CATCHUP
+    if (timer[slot].catchUp == CATCHUP_COALESCE)
+      timer[slot].deferredMissedRuns += missedRuns + 1;
+#endif
+
+    // but don't lose the deletion after the last run
+    if (call == DEFCALL_RUNANDDEL)
+      timer[slot].deferredCall = DEFCALL_RUNANDDEL;
+
+    return;
+  }
+
+  uint8_t next = deferredHead + 1;
+
+  if (next == DEFERRED_RING_SIZE)
+    next = 0;
+
+  // Only possible with stale entries of timers deleted before being drained. Drop this run
+  if (next == deferredTail)
+    return;
+
+  timer[slot].deferredCall        = call;
+#if ISR_TIMER_CATCHUP
+  timer[slot].deferredMissedRuns  = missedRuns;
+#else
+  (void) missedRuns;
+#endif
+  deferredRing[deferredHead]      = slot;
+
+  // publish the entry last
+  deferredHead = next;
+}
+
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+unsigned ISR_TimerN<NUM_TIMERS, TIME_BASE>::drain(unsigned long budget_us)
+{
+  unsigned numCalled = 0;
+  unsigned long start = micros();
+
+  while (deferredTail != deferredHead)
+  {
+    if ( budget_us && (numCalled > 0) && ( (micros() - start) >= budget_us ) )
+      break;
+
+    uint8_t i     = deferredRing[deferredTail];
+    uint8_t next  = deferredTail + 1;
+
+    if (next == DEFERRED_RING_SIZE)
+      next = 0;
+
+    deferredTail = next;
+
+    // Cleared before the call, so that the timer can be queued again meanwhile. Not to miss a
+    // DEFCALL_RUNANDDEL coalesced by run() in between, reading and clearing must be atomic
+    ISR_TIMER_ENTER_CRITICAL();
+
+    uint8_t call = timer[i].deferredCall;
+#if ISR_TIMER_CATCHUP
+    unsigned long missedRuns = timer[i].deferredMissedRuns;
+#else
+    unsigned long missedRuns = 0;
+#endif
+    uint8_t generation = timer[i].generation;
+    timer[i].deferredCall = DEFCALL_DONTRUN;
+
+    ISR_TIMER_EXIT_CRITICAL();
+
+    // the timer can have been deleted since it was queued
+    if ( (call == DEFCALL_DONTRUN) || (!callbacks[i].isBound()) )
+      continue;
+
+#if ISR_TIMER_STATS
+    unsigned long latency     = TIME_BASE() - timer[i].prev_millis;
+    unsigned long startMicros = micros();
+#endif
+
+    callTimer(i, missedRuns);
+
+#if ISR_TIMER_STATS
+    if (callbacks[i].isBound())
+      updateStats(i, latency, micros() - startMicros);
+#endif
+
+    numCalled++;
+
+    // unless deleted by its own callback, and maybe the slot reused meanwhile
+    if (call == DEFCALL_RUNANDDEL)
+    {
+      ISR_TIMER_ENTER_CRITICAL();
+
+      if (timer[i].generation == generation)
+        deleteSlot(i);
+
+      ISR_TIMER_EXIT_CRITICAL();
+    }
+  }
+
+  return numCalled;
+}
+
+#endif    // #if ISR_TIMER_DEFERRED
+
+// pop the first available slot from the free list
+// return -1 if none found
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+int ISR_TimerN<NUM_TIMERS, TIME_BASE>::findFirstFreeSlot()
+{
+  // all slots are used
+  if (freeHead == NO_FREE_SLOT)
+  {
+    return -1;
+  }
+
+  uint8_t slot = freeHead;
+
+  freeHead = timer[slot].nextFree;
+
+  return slot;
+}
+
+// slot of a timer handle, -1 if out of range, unused, or stale (its timer was deleted).
+// Called within ISR_TIMER_ENTER_CRITICAL(), held until the slot is used, so that run() can't free it in between
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+int ISR_TimerN<NUM_TIMERS, TIME_BASE>::slotOf(unsigned numTimer)
+{
+  uint8_t slot = numTimer & HANDLE_SLOT_MASK;
+
+  if ( (slot >= MAX_TIMERS) || ( (numTimer >> HANDLE_SLOT_BITS) != timer[slot].generation ) || (!callbacks[slot].isBound()) )
+  {
+    return -1;
+  }
+
+  return slot;
+}
+
+
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+int ISR_TimerN<NUM_TIMERS, TIME_BASE>::setupTimer(unsigned long d, const TimerDelegate& f, unsigned n, unsigned long slack,
+                                                  uint8_t catchUp)
+{
+  int freeTimer;
+
+  if (numTimers < 0)
+  {
+    init();
+  }
+
+  if (!f.isBound())
+  {
+    return -1;
+  }
+
+  unsigned long current_millis = TIME_BASE();
+  unsigned long phase = 0;
+
+  // computed before disabling interrupts, as it's a bit long
+  if ( spreadTick && (n != RUN_ONCE) )
+    phase = spreadPhase(current_millis + d, d);
+
+  ISR_TIMER_ENTER_CRITICAL();
+
+  freeTimer = findFirstFreeSlot();
+
+  if (freeTimer < 0)
+  {
+    ISR_TIMER_EXIT_CRITICAL();
+
+    return -1;
+  }
+
+  timer[freeTimer].delay        = d;
+  callbacks[freeTimer]          = f;
+  timer[freeTimer].maxNumRuns   = n;
+  timer[freeTimer].enabled      = true;
+  timer[freeTimer].prev_millis  = current_millis + phase;
+
+#if ISR_TIMER_CATCHUP
+  timer[freeTimer].catchUp      = catchUp;
+  timer[freeTimer].burstCap     = 1;
+#else
+  (void) catchUp;
+#endif
+
+#if ISR_TIMER_STATS
+  memset((void*) &stats[freeTimer], 0, sizeof (stats_t));
+#endif
+
+#if ISR_TIMER_SLACK
+  timer[freeTimer].slack        = slack;
+
+  if (slack > 0)
+    numSlackTimers++;
+#else
+  (void) slack;
+#endif
+
+  heapInsert(freeTimer);
+
+  numTimers++;
+
+  // the new timer is the next one due
+  if ( ticklessCallback && (deadlineHeap[0] == freeTimer) )
+    reprogramTickless();
+
+  ISR_TIMER_EXIT_CRITICAL();
+
+  return (timer[freeTimer].generation << HANDLE_SLOT_BITS) | freeTimer;
 }
 
-void ISR_Timer::init()
-{
-  unsigned long current_millis = millis();   //elapsed();
 
-  for (uint8_t i = 0; i < MAX_TIMERS; i++)
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+unsigned long ISR_TimerN<NUM_TIMERS, TIME_BASE>::gcd(unsigned long a, unsigned long b)
+{
+  while (b != 0)
   {
-    memset((void*) &timer[i], 0, sizeof (timer_t));
-    timer[i].prev_millis = current_millis;
+    unsigned long r = a % b;
+
+    a = b;
+    b = r;
   }
 
-  numTimers = 0;
+  return a;
 }
 
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+bool ISR_TimerN<NUM_TIMERS, TIME_BASE>::shareTick(unsigned long deadlineA, unsigned long delayA,
+                                                   unsigned long deadlineB, unsigned long delayB, unsigned long tick)
+{
+  // deadlineA + k * delayA = deadlineB + m * delayB has a solution iff gcd(delayA, delayB) divides the difference
+  unsigned long g = gcd(delayA, delayB);
+
+  if (g == 0)
+    return true;
+
+  long diff = (long) (deadlineA - deadlineB);
+  unsigned long r = (unsigned long) ( (diff >= 0) ? diff : -diff ) % g;
+
+  return (r < tick) || ( (g - r) < tick );
+}
 
-void ISR_Timer::run()
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+unsigned long ISR_TimerN<NUM_TIMERS, TIME_BASE>::spreadPhase(unsigned long firstDeadline, unsigned long d)
 {
-  uint8_t i;
-  unsigned long current_millis;
+  uint8_t numPhases = SPREAD_MAX_PHASES;
 
-  // get current time
-  current_millis = millis();   //elapsed();
+  if (d / spreadTick < numPhases)
+    numPhases = (d / spreadTick > 0) ? d / spreadTick : 1;
 
-  for (i = 0; i < MAX_TIMERS; i++)
+  // number of existing timers sharing a tick with the new one, for each candidate phase
+  uint8_t numShared[SPREAD_MAX_PHASES];
+
+  memset(numShared, 0, sizeof(numShared));
+
+  for (uint8_t i = 0; i < MAX_TIMERS; i++)
   {
-    timer[i].toBeCalled = DEFCALL_DONTRUN;
+    ISR_TIMER_ENTER_CRITICAL();
 
-    // no callback == no timer, i.e. jump over empty slots
-    if (timer[i].callback != NULL)
-    {
-      // is it time to process this timer ?
-      // see http://arduino.cc/forum/index.php/topic,124048.msg932592.html#msg932592
+    bool used = (callbacks[i].isBound()) && (timer[i].heapIndex != NOT_IN_HEAP);
 
-      if ((current_millis - timer[i].prev_millis) >= timer[i].delay)
-      {
-        unsigned long skipTimes = (current_millis - timer[i].prev_millis) / timer[i].delay;
-        // update time
-        timer[i].prev_millis += timer[i].delay * skipTimes;
-
-        // check if the timer callback has to be executed
-        if (timer[i].enabled)
-        {
-          // "run forever" timers must always be executed
-          if (timer[i].maxNumRuns == RUN_FOREVER)
-          {
-            timer[i].toBeCalled = DEFCALL_RUNONLY;
-          }
-          // other timers get executed the specified number of times
-          else if (timer[i].numRuns < timer[i].maxNumRuns)
-          {
-            timer[i].toBeCalled = DEFCALL_RUNONLY;
-            timer[i].numRuns++;
-
-            // after the last run, delete the timer
-            if (timer[i].numRuns >= timer[i].maxNumRuns)
-            {
-              timer[i].toBeCalled = DEFCALL_RUNANDDEL;
-            }
-          }
-        }
-      }
+    // prev_millis only moves by whole intervals, so the tick sharing doesn't depend on when it's read
+    unsigned long deadline  = timer[i].prev_millis + timer[i].delay;
+    unsigned long delay     = timer[i].delay;
+
+    ISR_TIMER_EXIT_CRITICAL();
+
+    if (!used)
+      continue;
+
+    for (uint8_t phase = 0; phase < numPhases; phase++)
+    {
+      if (shareTick(firstDeadline + phase * spreadTick, d, deadline, delay, spreadTick))
+        numShared[phase]++;
     }
   }
 
-  for (i = 0; i < MAX_TIMERS; i++)
+  uint8_t best = 0;
+
+  for (uint8_t phase = 1; phase < numPhases; phase++)
   {
-    if (timer[i].toBeCalled == DEFCALL_DONTRUN)
-      continue;
+    if (numShared[phase] < numShared[best])
+      best = phase;
+  }
 
-    if (timer[i].hasParam)
-      (*(timer_callback_p)timer[i].callback)(timer[i].param);
-    else
-      (*(timer_callback)timer[i].callback)();
+  return best * spreadTick;
+}
 
-    if (timer[i].toBeCalled == DEFCALL_RUNANDDEL)
-      deleteTimer(i);
-  }
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+int ISR_TimerN<NUM_TIMERS, TIME_BASE>::setTimer(unsigned long d, timer_callback f, unsigned n)
+{
+  return setupTimer(d, TimerDelegate(f), n);
 }
 
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+int ISR_TimerN<NUM_TIMERS, TIME_BASE>::setTimer(unsigned long d, timer_callback_p f, void* p, unsigned n)
+{
+  return setupTimer(d, TimerDelegate(f, p), n);
+}
 
-// find the first available slot
-// return -1 if none found
-int ISR_Timer::findFirstFreeSlot()
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+int ISR_TimerN<NUM_TIMERS, TIME_BASE>::setInterval(unsigned long d, timer_callback f)
 {
-  // all slots are used
-  if (numTimers >= MAX_TIMERS)
-  {
-    return -1;
-  }
+  return setupTimer(d, TimerDelegate(f), RUN_FOREVER);
+}
 
-  // return the first slot with no callback (i.e. free)
-  for (uint8_t i = 0; i < MAX_TIMERS; i++)
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+int ISR_TimerN<NUM_TIMERS, TIME_BASE>::setInterval(unsigned long d, timer_callback_p f, void* p)
+{
+  return setupTimer(d, TimerDelegate(f, p), RUN_FOREVER);
+}
+
+#if ISR_TIMER_SLACK
+
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+int ISR_TimerN<NUM_TIMERS, TIME_BASE>::setInterval(unsigned long d, timer_callback f, unsigned long slack)
+{
+  return setupTimer(d, TimerDelegate(f), RUN_FOREVER, slack);
+}
+
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+int ISR_TimerN<NUM_TIMERS, TIME_BASE>::setInterval(unsigned long d, timer_callback_p f, void* p, unsigned long slack)
+{
+  return setupTimer(d, TimerDelegate(f, p), RUN_FOREVER, slack);
+}
+
+#endif    // #if ISR_TIMER_SLACK
+
+#if ISR_TIMER_CATCHUP
+
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+int ISR_TimerN<NUM_TIMERS, TIME_BASE>::setInterval(unsigned long d, timer_callback_missed f, void* p)
+{
+  return setupTimer(d, TimerDelegate(f, p), RUN_FOREVER, 0, CATCHUP_COALESCE);
+}
+
+#endif    // #if ISR_TIMER_CATCHUP
+
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+int ISR_TimerN<NUM_TIMERS, TIME_BASE>::setInterval(unsigned long d, const TimerDelegate& f)
+{
+  return setupTimer(d, f, RUN_FOREVER);
+}
+
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+int ISR_TimerN<NUM_TIMERS, TIME_BASE>::setTimeout(unsigned long d, const TimerDelegate& f)
+{
+  return setupTimer(d, f, RUN_ONCE);
+}
+
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+int ISR_TimerN<NUM_TIMERS, TIME_BASE>::setTimer(unsigned long d, const TimerDelegate& f, unsigned n)
+{
+  return setupTimer(d, f, n);
+}
+
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+int ISR_TimerN<NUM_TIMERS, TIME_BASE>::setTimeout(unsigned long d, timer_callback f)
+{
+  return setupTimer(d, TimerDelegate(f), RUN_ONCE);
+}
+
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+int ISR_TimerN<NUM_TIMERS, TIME_BASE>::setTimeout(unsigned long d, timer_callback_p f, void* p)
+{
+  return setupTimer(d, TimerDelegate(f, p), RUN_ONCE);
+}
+
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+bool ISR_TimerN<NUM_TIMERS, TIME_BASE>::changeInterval(unsigned numTimer, unsigned long d)
+{
+  ISR_TIMER_ENTER_CRITICAL();
+
+  int slot = slotOf(numTimer);
+
+  if (slot < 0)
   {
-    if (timer[i].callback == NULL)
-    {
-      return i;
-    }
+    ISR_TIMER_EXIT_CRITICAL();
+
+    return false;
   }
 
-  // no free slots found
-  return -1;
-}
+  // Updates interval of existing specified timer
+  timer[slot].delay = d;
+  timer[slot].prev_millis = TIME_BASE();
+  heapUpdate(slot);
+
+  if (ticklessCallback)
+    reprogramTickless();
+
+  ISR_TIMER_EXIT_CRITICAL();
 
+  return true;
+}
 
-int ISR_Timer::setupTimer(unsigned long d, void* f, void* p, bool h, unsigned n)
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+void ISR_TimerN<NUM_TIMERS, TIME_BASE>::deleteTimer(unsigned numTimer)
 {
-  int freeTimer;
+  ISR_TIMER_ENTER_CRITICAL();
 
-  if (numTimers < 0)
+  int slot = slotOf(numTimer);
+
+  if (slot < 0)
   {
-    init();
+    ISR_TIMER_EXIT_CRITICAL();
+
+    return;
   }
 
-  freeTimer = findFirstFreeSlot();
+  deleteSlot(slot);
 
-  if (freeTimer < 0)
+  ISR_TIMER_EXIT_CRITICAL();
+}
+
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+void ISR_TimerN<NUM_TIMERS, TIME_BASE>::deleteSlot(uint8_t slot)
+{
+  // nothing to delete if the specified slot is already empty, so that it isn't
+  // pushed twice on the free list
+  if ( (numTimers == 0) || (!callbacks[slot].isBound()) )
   {
-    return -1;
+    return;
   }
 
-  if (f == NULL)
+  heapRemove(slot);
+
+#if ISR_TIMER_SLACK
+  if (timer[slot].slack > 0)
+    numSlackTimers--;
+#endif
+
+  // handles of the deleted timer become stale
+  uint8_t generation = (timer[slot].generation + 1) & GENERATION_MASK;
+
+  memset((void*) &timer[slot], 0, sizeof (timer_t));
+  callbacks[slot]         = TimerDelegate();
+  timer[slot].prev_millis = TIME_BASE();
+  timer[slot].generation  = generation;
+
+  // back to the free list
+  timer[slot].nextFree    = freeHead;
+  freeHead                = slot;
+
+  // update number of timers
+  numTimers--;
+
+  // nothing left to wake up for. Otherwise, an early wake-up is harmless
+  if ( ticklessCallback && (heapSize == 0) )
+    reprogramTickless();
+}
+
+
+// function contributed by code@rowansimms.com
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+void ISR_TimerN<NUM_TIMERS, TIME_BASE>::restartTimer(unsigned numTimer)
+{
+  ISR_TIMER_ENTER_CRITICAL();
+
+  int slot = slotOf(numTimer);
+
+  if (slot < 0)
   {
-    return -1;
+    ISR_TIMER_EXIT_CRITICAL();
+
+    return;
   }
 
-  timer[freeTimer].delay        = d;
-  timer[freeTimer].callback     = f;
-  timer[freeTimer].param        = p;
-  timer[freeTimer].hasParam     = h;
-  timer[freeTimer].maxNumRuns   = n;
-  timer[freeTimer].enabled      = true;
-  timer[freeTimer].prev_millis  = elapsed();
+  timer[slot].prev_millis = TIME_BASE();
+  heapUpdate(slot);
 
-  numTimers++;
+  if ( ticklessCallback && (timer[slot].heapIndex == 0) )
+    reprogramTickless();
 
-  return freeTimer;
+  ISR_TIMER_EXIT_CRITICAL();
 }
 
 
-int ISR_Timer::setTimer(unsigned long d, timer_callback f, unsigned n)
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+bool ISR_TimerN<NUM_TIMERS, TIME_BASE>::setPhase(unsigned numTimer, unsigned long phase)
 {
-  return setupTimer(d, (void *)f, NULL, false, n);
+  ISR_TIMER_ENTER_CRITICAL();
+
+  int slot = slotOf(numTimer);
+
+  if (slot < 0)
+  {
+    ISR_TIMER_EXIT_CRITICAL();
+
+    return false;
+  }
+
+  timer[slot].prev_millis += phase;
+  heapUpdate(slot);
+
+  if (ticklessCallback)
+    reprogramTickless();
+
+  ISR_TIMER_EXIT_CRITICAL();
+
+  return true;
 }
 
-int ISR_Timer::setTimer(unsigned long d, timer_callback_p f, void* p, unsigned n)
+
+#if ISR_TIMER_CATCHUP
+
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+bool ISR_TimerN<NUM_TIMERS, TIME_BASE>::setCatchUp(unsigned numTimer, uint8_t policy, uint8_t burstCap)
 {
-  return setupTimer(d, (void *)f, p, true, n);
+  ISR_TIMER_ENTER_CRITICAL();
+
+  int slot = slotOf(numTimer);
+
+  if ( (slot < 0) || (policy > CATCHUP_COALESCE) )
+  {
+    ISR_TIMER_EXIT_CRITICAL();
+
+    return false;
+  }
+
+  timer[slot].catchUp   = policy;
+  timer[slot].burstCap  = (burstCap > 0) ? burstCap : 1;
+
+  ISR_TIMER_EXIT_CRITICAL();
+
+  return true;
 }
 
-int ISR_Timer::setInterval(unsigned long d, timer_callback f)
+#endif    // #if ISR_TIMER_CATCHUP
+
+#if ISR_TIMER_PRIORITY
+
+
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+bool ISR_TimerN<NUM_TIMERS, TIME_BASE>::setPriority(unsigned numTimer, uint8_t priority)
 {
-  return setupTimer(d, (void *)f, NULL, false, RUN_FOREVER);
+  ISR_TIMER_ENTER_CRITICAL();
+
+  int slot = slotOf(numTimer);
+
+  if (slot < 0)
+  {
+    ISR_TIMER_EXIT_CRITICAL();
+
+    return false;
+  }
+
+  timer[slot].priority = priority;
+
+  ISR_TIMER_EXIT_CRITICAL();
+
+  return true;
 }
 
-int ISR_Timer::setInterval(unsigned long d, timer_callback_p f, void* p)
+#endif    // #if ISR_TIMER_PRIORITY
+
+#if ISR_TIMER_DEADLINE_MISS
+
+
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+bool ISR_TimerN<NUM_TIMERS, TIME_BASE>::setMaxLateness(unsigned numTimer, unsigned long maxLateness)
 {
-  return setupTimer(d, (void *)f, p, true, RUN_FOREVER);
+  ISR_TIMER_ENTER_CRITICAL();
+
+  int slot = slotOf(numTimer);
+
+  if (slot < 0)
+  {
+    ISR_TIMER_EXIT_CRITICAL();
+
+    return false;
+  }
+
+  timer[slot].maxLateness     = maxLateness;
+  timer[slot].deadlineMisses  = 0;
+
+  ISR_TIMER_EXIT_CRITICAL();
+
+  return true;
 }
 
-int ISR_Timer::setTimeout(unsigned long d, timer_callback f)
+
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+unsigned ISR_TimerN<NUM_TIMERS, TIME_BASE>::getDeadlineMisses(unsigned numTimer)
 {
-  return setupTimer(d, (void *)f, NULL, false, RUN_ONCE);
+  ISR_TIMER_ENTER_CRITICAL();
+
+  int slot = slotOf(numTimer);
+
+  if (slot < 0)
+  {
+    ISR_TIMER_EXIT_CRITICAL();
+
+    return 0;
+  }
+
+  unsigned deadlineMisses = timer[slot].deadlineMisses;
+
+  ISR_TIMER_EXIT_CRITICAL();
+
+  return deadlineMisses;
 }
 
-int ISR_Timer::setTimeout(unsigned long d, timer_callback_p f, void* p)
+
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+void ISR_TimerN<NUM_TIMERS, TIME_BASE>::setDeadlineMissHook(timer_miss_callback f)
 {
-  return setupTimer(d, (void *)f, p, true, RUN_ONCE);
+  missCallback = f;
 }
 
-bool ISR_Timer::changeInterval(unsigned numTimer, unsigned long d)
+#endif    // #if ISR_TIMER_DEADLINE_MISS
+
+
+#if ISR_TIMER_STATS
+
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+bool ISR_TimerN<NUM_TIMERS, TIME_BASE>::getStats(unsigned numTimer, timer_stats_t& stat)
 {
-  if (numTimer >= MAX_TIMERS)
+  ISR_TIMER_ENTER_CRITICAL();
+
+  int slot = slotOf(numTimer);
+
+  if (slot < 0)
   {
+    ISR_TIMER_EXIT_CRITICAL();
+
     return false;
   }
 
-  // Updates interval of existing specified timer
-  if (timer[numTimer].callback != NULL)
-  {
-    timer[numTimer].delay = d;
-    timer[numTimer].prev_millis = elapsed();
-    return true;
-  }
+  stat.numCalls       = stats[slot].numCalls;
+  stat.minExecMicros  = stats[slot].minExecMicros;
+  stat.maxExecMicros  = stats[slot].maxExecMicros;
+  stat.meanExecMicros = stats[slot].numCalls ? stats[slot].totalExecMicros / stats[slot].numCalls : 0;
+  stat.minLatency     = stats[slot].minLatency;
+  stat.maxLatency     = stats[slot].maxLatency;
+  stat.meanLatency    = stats[slot].numCalls ? stats[slot].totalLatency / stats[slot].numCalls : 0;
+
+  ISR_TIMER_EXIT_CRITICAL();
 
-  // false return for non-used numTimer, no callback
-  return false;
+  return true;
 }
 
-void ISR_Timer::deleteTimer(unsigned timerId)
+
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+void ISR_TimerN<NUM_TIMERS, TIME_BASE>::resetStats(unsigned numTimer)
 {
-  if (timerId >= MAX_TIMERS)
+  ISR_TIMER_ENTER_CRITICAL();
+
+  int slot = slotOf(numTimer);
+
+  if (slot < 0)
   {
+    ISR_TIMER_EXIT_CRITICAL();
+
     return;
   }
 
-  // nothing to delete if no timers are in use
-  if (numTimers == 0)
+  memset((void*) &stats[slot], 0, sizeof (stats_t));
+
+  ISR_TIMER_EXIT_CRITICAL();
+}
+
+#endif    // #if ISR_TIMER_STATS
+
+
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+void ISR_TimerN<NUM_TIMERS, TIME_BASE>::setAutoSpread(bool enabled, unsigned long tick)
+{
+  spreadTick = enabled ? ( (tick > 0) ? tick : 1 ) : 0;
+}
+
+
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+unsigned ISR_TimerN<NUM_TIMERS, TIME_BASE>::getMaxCallbacksPerTick(unsigned long tick)
+{
+  unsigned maxCallbacks = 0;
+
+  if (tick == 0)
+    tick = 1;
+
+  // the enabled timers sharing a tick with timer i, and timer i itself
+  for (uint8_t i = 0; i < MAX_TIMERS; i++)
   {
-    return;
+    ISR_TIMER_ENTER_CRITICAL();
+
+    bool used = (callbacks[i].isBound()) && (timer[i].heapIndex != NOT_IN_HEAP) && timer[i].enabled;
+    unsigned long deadline  = timer[i].prev_millis + timer[i].delay;
+    unsigned long delay     = timer[i].delay;
+
+    ISR_TIMER_EXIT_CRITICAL();
+
+    if (!used)
+      continue;
+
+    unsigned numCallbacks = 1;
+
+    for (uint8_t j = 0; j < MAX_TIMERS; j++)
+    {
+      if (j == i)
+        continue;
+
+      ISR_TIMER_ENTER_CRITICAL();
+
+      bool usedJ = (callbacks[j].isBound()) && (timer[j].heapIndex != NOT_IN_HEAP) && timer[j].enabled;
+      unsigned long deadlineJ = timer[j].prev_millis + timer[j].delay;
+      unsigned long delayJ    = timer[j].delay;
+
+      ISR_TIMER_EXIT_CRITICAL();
+
+      if (usedJ && shareTick(deadline, delay, deadlineJ, delayJ, tick))
+        numCallbacks++;
+    }
+
+    if (numCallbacks > maxCallbacks)
+      maxCallbacks = numCallbacks;
   }
 
-  // don't decrease the number of timers if the
-  // specified slot is already empty
-  if (timer[timerId].callback != NULL)
+  return maxCallbacks;
+}
+
+
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+bool ISR_TimerN<NUM_TIMERS, TIME_BASE>::isEnabled(unsigned numTimer)
+{
+  ISR_TIMER_ENTER_CRITICAL();
+
+  int slot = slotOf(numTimer);
+
+  if (slot < 0)
   {
-    memset((void*) &timer[timerId], 0, sizeof (timer_t));
-    timer[timerId].prev_millis = elapsed();
+    ISR_TIMER_EXIT_CRITICAL();
 
-    // update number of timers
-    numTimers--;
+    return false;
   }
+
+  bool enabled = timer[slot].enabled;
+
+  ISR_TIMER_EXIT_CRITICAL();
+
+  return enabled;
 }
 
 
-// function contributed by code@rowansimms.com
-void ISR_Timer::restartTimer(unsigned numTimer)
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+void ISR_TimerN<NUM_TIMERS, TIME_BASE>::enable(unsigned numTimer)
 {
-  if (numTimer >= MAX_TIMERS)
+  ISR_TIMER_ENTER_CRITICAL();
+
+  int slot = slotOf(numTimer);
+
+  if (slot < 0)
   {
+    ISR_TIMER_EXIT_CRITICAL();
+
     return;
   }
 
-  timer[numTimer].prev_millis = elapsed();
+  timer[slot].enabled = true;
+
+  ISR_TIMER_EXIT_CRITICAL();
 }
 
 
-bool ISR_Timer::isEnabled(unsigned numTimer)
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+void ISR_TimerN<NUM_TIMERS, TIME_BASE>::disable(unsigned numTimer)
 {
-  if (numTimer >= MAX_TIMERS)
+  ISR_TIMER_ENTER_CRITICAL();
+
+  int slot = slotOf(numTimer);
+
+  if (slot < 0)
   {
-    return false;
+    ISR_TIMER_EXIT_CRITICAL();
+
+    return;
   }
 
-  return timer[numTimer].enabled;
+  timer[slot].enabled = false;
+
+  ISR_TIMER_EXIT_CRITICAL();
 }
 
+#if ISR_TIMER_DEFERRED
 
-void ISR_Timer::enable(unsigned numTimer)
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+void ISR_TimerN<NUM_TIMERS, TIME_BASE>::setDeferred(unsigned numTimer, bool deferred)
 {
-  if (numTimer >= MAX_TIMERS)
+  ISR_TIMER_ENTER_CRITICAL();
+
+  int slot = slotOf(numTimer);
+
+  if (slot < 0)
   {
+    ISR_TIMER_EXIT_CRITICAL();
+
     return;
   }
 
-  timer[numTimer].enabled = true;
+  timer[slot].deferred = deferred;
+
+  ISR_TIMER_EXIT_CRITICAL();
 }
 
 
-void ISR_Timer::disable(unsigned numTimer)
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+bool ISR_TimerN<NUM_TIMERS, TIME_BASE>::isDeferred(unsigned numTimer)
 {
-  if (numTimer >= MAX_TIMERS)
+  ISR_TIMER_ENTER_CRITICAL();
+
+  int slot = slotOf(numTimer);
+
+  if (slot < 0)
   {
-    return;
+    ISR_TIMER_EXIT_CRITICAL();
+
+    return false;
   }
 
-  timer[numTimer].enabled = false;
+  bool deferred = timer[slot].deferred;
+
+  ISR_TIMER_EXIT_CRITICAL();
+
+  return deferred;
 }
 
-void ISR_Timer::enableAll()
+#endif    // #if ISR_TIMER_DEFERRED
+
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+void ISR_TimerN<NUM_TIMERS, TIME_BASE>::enableAll()
 {
   // Enable all timers with a callback assigned (used)
   for (uint8_t i = 0; i < MAX_TIMERS; i++)
   {
-    if (timer[i].callback != NULL && timer[i].numRuns == RUN_FOREVER)
+    if (callbacks[i].isBound() && timer[i].numRuns == RUN_FOREVER)
     {
       timer[i].enabled = true;
     }
   }
 }
 
-void ISR_Timer::disableAll()
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+void ISR_TimerN<NUM_TIMERS, TIME_BASE>::disableAll()
 {
   // Disable all timers with a callback assigned (used)
   for (uint8_t i = 0; i < MAX_TIMERS; i++)
   {
-    if (timer[i].callback != NULL && timer[i].numRuns == RUN_FOREVER)
+    if (callbacks[i].isBound() && timer[i].numRuns == RUN_FOREVER)
     {
       timer[i].enabled = false;
     }
   }
 }
 
-void ISR_Timer::toggle(unsigned numTimer)
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+void ISR_TimerN<NUM_TIMERS, TIME_BASE>::toggle(unsigned numTimer)
 {
-  if (numTimer >= MAX_TIMERS)
+  ISR_TIMER_ENTER_CRITICAL();
+
+  int slot = slotOf(numTimer);
+
+  if (slot < 0)
   {
+    ISR_TIMER_EXIT_CRITICAL();
+
     return;
   }
 
-  timer[numTimer].enabled = !timer[numTimer].enabled;
+  timer[slot].enabled = !timer[slot].enabled;
+
+  ISR_TIMER_EXIT_CRITICAL();
 }
 
 
-unsigned ISR_Timer::getNumTimers()
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE>
+unsigned ISR_TimerN<NUM_TIMERS, TIME_BASE>::getNumTimers()
 {
   return numTimers;
 }
@@ -66,57 +66,190 @@
 #endif
 #endif
 
-typedef void (*timer_callback)(void);
-typedef void (*timer_callback_p)(void *);
+// Per-timer execution time and latency statistics of the callbacks, see ISR_TimerN::getStats().
+// Zero cost if false (default)
+#ifndef ISR_TIMER_STATS
+  #define ISR_TIMER_STATS         false
+#endif
+
+// Optional features of ISR_TimerN, each costing RAM in every timer slot, so all off by default.
+// Slack-based coalescing of wake-ups, see setInterval(d, f, slack). 4 bytes per timer
+#ifndef ISR_TIMER_SLACK
+  #define ISR_TIMER_SLACK         false
+#endif
+
+// Catch-up policy of late runs, see setCatchUp(), and timer_callback_missed callbacks. 7 bytes per timer
+#ifndef ISR_TIMER_CATCHUP
+  #define ISR_TIMER_CATCHUP       false
+#endif
+
+// Deferred callbacks, called from loop() by drain(), see setDeferred(). 3 bytes per timer, 7 with ISR_TIMER_CATCHUP
+#ifndef ISR_TIMER_DEFERRED
+  #define ISR_TIMER_DEFERRED      false
+#endif
+
+// Priority order of the callbacks due in the same run(), see setPriority(). 1 byte per timer
+#ifndef ISR_TIMER_PRIORITY
+  #define ISR_TIMER_PRIORITY      false
+#endif
+
+// Deadline-miss detection, see setMaxLateness(). 6 bytes per timer
+#ifndef ISR_TIMER_DEADLINE_MISS
+  #define ISR_TIMER_DEADLINE_MISS false
+#endif
+
+// Baseline of the ISR_Timer_Benchmark example: run() checks all the slots on every tick, as before the deadline heap,
+// instead of a single compare with the first deadline. Only to compare both, false (default) otherwise
+#ifndef ISR_TIMER_LINEAR_SCAN
+  #define ISR_TIMER_LINEAR_SCAN   false
+#endif
+
+// timer_callback, timer_callback_p, timer_callback_missed and TimerDelegate
+#include "TimerDelegate.hpp"
 
-class ISR_Timer 
+// Tickless mode: called with the interval (in time base units) until the next due timer, 0 if there's no timer left.
+// It must reprogram the hardware timer to interrupt after that interval, such as with TimerInterrupt::setNextInterval()
+// or TimerInterrupt::setNextIntervalMicros()
+typedef void (*timer_tickless_callback)(unsigned long interval);
+
+// Deadline-miss hook: called with the timer handle and how late (in time base units) its callback started
+typedef void (*timer_miss_callback)(unsigned numTimer, unsigned long lateness);
+
+#if ISR_TIMER_STATS
+
+// Statistics of one timer. Execution times are measured with micros(), i.e. with the Timer0 counter (4us resolution
+// at 16MHz). Start latencies, from the deadline to the callback call, are in time base units. Jitter is max - min latency
+typedef struct
+{
+  unsigned long numCalls;
+  unsigned long minExecMicros;
+  unsigned long maxExecMicros;
+  unsigned long meanExecMicros;
+  unsigned long minLatency;
+  unsigned long maxLatency;
+  unsigned long meanLatency;
+} timer_stats_t;
+
+#endif    // #if ISR_TIMER_STATS
+
+// Time base of ISR_TimerN, returning the current time. All intervals are in its unit
+typedef unsigned long (*timer_time_base)(void);
+
+// ISR_Timer data is shared between the hardware timer ISR and loop(). Save / restore the interrupt state
+// instead of blindly calling interrupts(), so the API is also safe to use from inside ISR_Timer callbacks
+#if defined(SREG)
+  #define ISR_TIMER_ENTER_CRITICAL()      uint8_t _sregSaved = SREG; noInterrupts()
+  #define ISR_TIMER_EXIT_CRITICAL()       SREG = _sregSaved
+#else
+  #define ISR_TIMER_ENTER_CRITICAL()      noInterrupts()
+  #define ISR_TIMER_EXIT_CRITICAL()       interrupts()
+#endif
+
+// ISR_TimerN<N> holds N ISR-based timers. The capacity is fixed at compile time, so RAM is only reserved for
+// the timers really needed, and all the loops over the slots have constant bounds. On AVR, each timer takes
+// 27 bytes, 17 plus its TimerDelegate of TIMER_DELEGATE_CONTEXT_SIZE + 4 bytes, and more with the optional
+// ISR_TIMER_SLACK, ISR_TIMER_CATCHUP, ISR_TIMER_DEFERRED, ISR_TIMER_PRIORITY, ISR_TIMER_DEADLINE_MISS and ISR_TIMER_STATS.
+// ISR_Timer is the original 16-timer version.
+//
+// Timer handles (numTimer) are the slot number plus a generation counter, bumped each time the slot is freed.
+// The functions taking a handle ignore stale ones, such as the one of a setTimeout() timer already fired and deleted,
+// instead of acting on another timer reusing the slot. Until the first reuse of a slot, its handle is the slot number.
+//
+// TIME_BASE is millis() by default, so intervals are in milliseconds. With TIMER_INTERRUPT_TIME_BASE, a function
+// returning TimerInterrupt::getMicros() of the hardware timer calling run() gives intervals in microseconds,
+// with sub-tick accuracy and without calling millis() in the ISR. Intervals must be less than 2^31 time base units.
+template<uint8_t NUM_TIMERS, timer_time_base TIME_BASE = millis>
+class ISR_TimerN
 {
+  static_assert( (NUM_TIMERS > 0) && (NUM_TIMERS < 255), "ISR_TimerN capacity must be 1 to 254 timers");
+
   public:
     // maximum number of timers
-    const static int MAX_TIMERS = 16;
+    const static int MAX_TIMERS = NUM_TIMERS;
 
     // setTimer() constants
     const static int RUN_FOREVER = 0;
     const static int RUN_ONCE = 1;
 
+    // setCatchUp() policies, with ISR_TIMER_CATCHUP
+    const static uint8_t CATCHUP_SKIP     = 0;
+    const static uint8_t CATCHUP_BURST    = 1;
+    const static uint8_t CATCHUP_COALESCE = 2;
+
     // constructor
-    ISR_Timer();
+    ISR_TimerN();
 
     void  init();
 
     // this function must be called inside loop()
     void  run();
 
+    // Tickless mode: instead of a fixed-rate hardware timer calling run() every tick, 'f' is called to reprogram
+    // the hardware timer to interrupt right at the next deadline, so that there's one interrupt per timer expiry.
+    // NULL goes back to the fixed-rate mode
+    void  setTickless(timer_tickless_callback f);
+
     // Timer will call function 'f' every 'd' milliseconds forever
-    // returns the timer number (numTimer) on success or
+    // returns the timer handle (numTimer) on success or
     // -1 on failure (f == NULL) or no free timers
     int setInterval(unsigned long d, timer_callback f);
 
     // Timer will call function 'f' with parameter 'p' every 'd' milliseconds forever
-    // returns the timer number (numTimer) on success or
+    // returns the timer handle (numTimer) on success or
     // -1 on failure (f == NULL) or no free timers
     int setInterval(unsigned long d, timer_callback_p f, void* p);
 
+#if ISR_TIMER_SLACK
+    // Same as setInterval(d, f), but in tickless mode, each run can be up to 'slack' milliseconds late. When another
+    // timer wakes run() up within that window, this one runs too, so that timers with overlapping windows share a
+    // single wake-up. With a fixed tick, it runs at its deadline, as there's no wake-up to save
+    int setInterval(unsigned long d, timer_callback f, unsigned long slack);
+
+    // Same as setInterval(d, f, p), with 'slack' milliseconds of tolerance
+    int setInterval(unsigned long d, timer_callback_p f, void* p, unsigned long slack);
+#endif
+
+#if ISR_TIMER_CATCHUP
+    // Timer will call function 'f' with parameter 'p' and the number of missed runs every 'd' milliseconds forever.
+    // Its catch-up policy is CATCHUP_COALESCE
+    int setInterval(unsigned long d, timer_callback_missed f, void* p);
+#endif
+
+    // Timer will call TimerDelegate 'f', such as a member function, every 'd' milliseconds forever
+    // returns the timer handle (numTimer) on success or
+    // -1 on failure (f unbound) or no free timers
+    int setInterval(unsigned long d, const TimerDelegate& f);
+
     // Timer will call function 'f' after 'd' milliseconds one time
-    // returns the timer number (numTimer) on success or
+    // returns the timer handle (numTimer) on success or
     // -1 on failure (f == NULL) or no free timers
     int setTimeout(unsigned long d, timer_callback f);
 
     // Timer will call function 'f' with parameter 'p' after 'd' milliseconds one time
-    // returns the timer number (numTimer) on success or
+    // returns the timer handle (numTimer) on success or
     // -1 on failure (f == NULL) or no free timers
     int setTimeout(unsigned long d, timer_callback_p f, void* p);
 
+    // Timer will call TimerDelegate 'f' after 'd' milliseconds one time
+    // returns the timer handle (numTimer) on success or
+    // -1 on failure (f unbound) or no free timers
+    int setTimeout(unsigned long d, const TimerDelegate& f);
+
     // Timer will call function 'f' every 'd' milliseconds 'n' times
-    // returns the timer number (numTimer) on success or
+    // returns the timer handle (numTimer) on success or
     // -1 on failure (f == NULL) or no free timers
     int setTimer(unsigned long d, timer_callback f, unsigned n);
 
     // Timer will call function 'f' with parameter 'p' every 'd' milliseconds 'n' times
-    // returns the timer number (numTimer) on success or
+    // returns the timer handle (numTimer) on success or
     // -1 on failure (f == NULL) or no free timers
     int setTimer(unsigned long d, timer_callback_p f, void* p, unsigned n);
 
+    // Timer will call TimerDelegate 'f' every 'd' milliseconds 'n' times
+    // returns the timer handle (numTimer) on success or
+    // -1 on failure (f unbound) or no free timers
+    int setTimer(unsigned long d, const TimerDelegate& f, unsigned n);
+
     // updates interval of the specified timer
     bool changeInterval(unsigned numTimer, unsigned long d);
 
@@ -145,6 +278,77 @@ class ISR_Timer
     // and vice-versa
     void toggle(unsigned numTimer);
 
+#if ISR_TIMER_CATCHUP
+    // Catch-up policy of the specified timer, when run() is called late and whole intervals were missed:
+    // CATCHUP_SKIP (default) calls the callback once, and drops the missed runs.
+    // CATCHUP_BURST replays all the missed runs, at most burstCap calls per run() to bound the ISR time.
+    // CATCHUP_COALESCE calls it once, with the number of missed runs for a timer_callback_missed callback
+    bool setCatchUp(unsigned numTimer, uint8_t policy, uint8_t burstCap = 4);
+#endif
+
+#if ISR_TIMER_PRIORITY
+    // Priority of the specified timer. The callbacks due in the same run() are called by decreasing priority,
+    // then by timer number. Default is 0
+    bool setPriority(unsigned numTimer, uint8_t priority);
+#endif
+
+#if ISR_TIMER_DEADLINE_MISS
+    // Deadline-miss detection of the specified timer: when its callback starts more than maxLateness (in time base
+    // units, us with a us time base) after its deadline, its deadline-miss counter is incremented and the
+    // deadline-miss hook is called. 0 (default) disables it. Deferred timers aren't checked
+    bool setMaxLateness(unsigned numTimer, unsigned long maxLateness);
+
+    // number of deadline misses of the specified timer since setMaxLateness()
+    unsigned getDeadlineMisses(unsigned numTimer);
+
+    // Called by run(), in the ISR, for each deadline miss. NULL (default) => no hook
+    void setDeadlineMissHook(timer_miss_callback f);
+#endif
+
+#if ISR_TIMER_STATS
+    // Statistics of the specified timer since it was set, or since resetStats(). Returns false for an invalid timer
+    bool getStats(unsigned numTimer, timer_stats_t& stats);
+
+    void resetStats(unsigned numTimer);
+#endif
+
+    // Phase of the specified timer: its next run, and so all the following ones, are delayed by 'phase'
+    // (in time base units). Keeps timers with intervals multiple of each other from running in the same tick
+    bool setPhase(unsigned numTimer, unsigned long phase);
+
+    // Automatic phase spreading: each new periodic timer (setInterval() and setTimer() with n > 1) gets the phase
+    // making it share a tick with the fewest existing timers. The phase is a multiple of 'tick', the interval
+    // between run() calls, less than the timer interval and SPREAD_MAX_PHASES ticks
+    void setAutoSpread(bool enabled, unsigned long tick = 1);
+
+    // Worst case number of callbacks called in the same tick, with the current intervals and phases, to size
+    // the ISR latency budget. It's an upper bound, exact when all timers sharing a tick with one timer also share
+    // it with each other, such as with harmonic intervals
+    unsigned getMaxCallbacksPerTick(unsigned long tick = 1);
+
+#if ISR_TIMER_DEFERRED
+    // Deferred ("bottom-half") mode of the specified timer: when due, run() only queues it,
+    // and its callback is called later from loop() by drain(). The ISR time doesn't depend on the callback any more
+    void setDeferred(unsigned numTimer, bool deferred = true);
+
+    // returns true if the specified timer is in deferred mode
+    bool isDeferred(unsigned numTimer);
+
+    // Call the queued deferred callbacks, in expiry order, until none is left or after budget_us microseconds.
+    // At least one queued callback is called, so the queue always progresses. budget_us = 0 => no limit.
+    // Must be called from loop(), returns the number of callbacks called
+    unsigned drain(unsigned long budget_us = 0);
+#endif
+
+#if ISR_TIMER_SLACK
+    // Number of timer runs coalesced into the wake-up of another timer thanks to their slack,
+    // i.e. wake-ups saved in tickless mode
+    unsigned long getWakeupsSaved()
+    {
+      return wakeupsSaved;
+    };
+#endif
+
     // returns the number of used timers
     unsigned  getNumTimers();
 
@@ -161,32 +365,217 @@ class ISR_Timer
     const static int DEFCALL_RUNONLY = 1;       // call the callback function but don't delete the timer
     const static int DEFCALL_RUNANDDEL = 2;     // call the callback function and delete the timer
 
-    // low level function to initialize and enable a new timer
-    // returns the timer number (numTimer) on success or
+    // number of candidate phases tried by the automatic spreading
+    const static uint8_t SPREAD_MAX_PHASES = 64;
+
+    // heapIndex of a slot not in the deadline heap
+    const static uint8_t NOT_IN_HEAP = 0xFF;
+
+    // end of the free slot list
+    const static uint8_t NO_FREE_SLOT = 0xFF;
+
+    // timer handle = (generation << HANDLE_SLOT_BITS) | slot, always positive in an int
+    const static uint8_t HANDLE_SLOT_BITS = 8;
+    const static uint8_t HANDLE_SLOT_MASK = 0xFF;
+    const static uint8_t GENERATION_MASK  = 0x7F;
+
+    static unsigned long gcd(unsigned long a, unsigned long b);
+
+    // true if the runs of both timers, of deadlines and intervals A and B, can happen in the same tick
+    static bool shareTick(unsigned long deadlineA, unsigned long delayA, unsigned long deadlineB, unsigned long delayB,
+                          unsigned long tick);
+
+    // phase (in time base units) of a new timer of interval d with its first run at firstDeadline, in automatic spreading mode
+    unsigned long spreadPhase(unsigned long firstDeadline, unsigned long d);
+
+    // low level function to initialize and enable a new timer. slack and catchUp are ignored without ISR_TIMER_SLACK
+    // and ISR_TIMER_CATCHUP. Returns the timer handle (numTimer) on success or
     // -1 on failure (f == NULL) or no free timers
-    int  setupTimer(unsigned long d, void* f, void* p, bool h, unsigned n);
+    int  setupTimer(unsigned long d, const TimerDelegate& f, unsigned n, unsigned long slack = 0, uint8_t catchUp = CATCHUP_SKIP);
 
-    // find the first available slot
+    // find the first available slot, from the free list
     int  findFirstFreeSlot();
 
+    // slot of a timer handle, -1 if stale or invalid. Within ISR_TIMER_ENTER_CRITICAL()
+    int  slotOf(unsigned numTimer);
+
+    // destroy the timer in the specified slot, if still used. Within ISR_TIMER_ENTER_CRITICAL()
+    void deleteSlot(uint8_t slot);
+
+    // Min-heap of the used slots, ordered by latest next deadline (prev_millis + delay + slack).
+    // Deadlines are compared as signed differences, so intervals must stay below 2^31 ms (~24.8 days), or us (~35 min)
+    bool deadlineBefore(uint8_t slotA, uint8_t slotB);
+    void heapSwap(uint8_t posA, uint8_t posB);
+    void heapSiftUp(uint8_t pos);
+    void heapSiftDown(uint8_t pos);
+    void heapInsert(uint8_t slot);
+    void heapRemove(uint8_t slot);
+    void heapUpdate(uint8_t slot);
+    void updateNextDeadline();
+
+    // Deadline ordering the heap. In tickless mode, the latest one within the slack, so that the hardware timer
+    // wakes up as late as possible and runs all the timers due by then. Otherwise run() is called every tick anyway,
+    // and timers run at their own deadline
+    unsigned long heapDeadline(uint8_t slot) __attribute__((always_inline))
+    {
+#if ISR_TIMER_SLACK
+      if (ticklessCallback)
+        return timer[slot].prev_millis + timer[slot].delay + timer[slot].slack;
+#endif
+
+      return timer[slot].prev_millis + timer[slot].delay;
+    }
+
+#if ISR_TIMER_SLACK
+    // reorder the whole heap, after heapDeadline() changed with the mode
+    void heapRebuild();
+#endif
+
+    // call order of the due timers in run(): by decreasing priority, then by slot
+    bool callBefore(uint8_t slotA, uint8_t slotB) __attribute__((always_inline))
+    {
+#if ISR_TIMER_PRIORITY
+      if (timer[slotA].priority != timer[slotB].priority)
+        return timer[slotA].priority > timer[slotB].priority;
+#endif
+
+      return slotA < slotB;
+    }
+
+    // process one due timer in run()
+    void expireTimer(uint8_t slot, unsigned long current_millis);
+
+    void callTimer(uint8_t slot, unsigned long missedRuns);
+
+#if ISR_TIMER_DEADLINE_MISS
+    void checkDeadline(uint8_t slot);
+#endif
+
+#if ISR_TIMER_STATS
+    // account one callback call, of latency and execution time
+    void updateStats(uint8_t slot, unsigned long latency, unsigned long execMicros);
+#endif
+
+    // tickless mode: pass the interval until the next deadline to ticklessCallback
+    void reprogramTickless();
+
+#if ISR_TIMER_DEFERRED
+    // queue a due deferred timer for drain(), called from run() only
+    void pushDeferred(uint8_t slot, uint8_t call, unsigned long missedRuns);
+#endif
+
     typedef struct 
     {
-      unsigned long prev_millis;        // value returned by the millis() function in the previous run() call
-      void* callback;                   // pointer to the callback function
-      void* param;                      // function parameter
-      bool hasParam;                 // true if callback takes a parameter
+      unsigned long prev_millis;        // value returned by TIME_BASE(), millis() by default, in the previous run() call
       unsigned long delay;              // delay value
       unsigned maxNumRuns;              // number of runs to be executed
       unsigned numRuns;                 // number of executed runs
       bool enabled;                  // true if enabled
-      unsigned toBeCalled;              // deferred function call (sort of) - N.B.: only used in run()
+      uint8_t toBeCalled;               // deferred function call (sort of) - N.B.: only used in run()
+      uint8_t generation;               // generation of the handle, incremented when the slot is freed
+
+      // a used slot is in the heap, except for a moment in run(), and an unused one in the free list
+      union
+      {
+        uint8_t heapIndex;              // position in deadlineHeap[] if used, NOT_IN_HEAP if not in it
+        uint8_t nextFree;               // next slot in the free list, if unused
+      };
+
+#if ISR_TIMER_SLACK
+      unsigned long slack;              // the timer can run up to slack late, to share a wake-up
+#endif
+
+#if ISR_TIMER_CATCHUP
+      uint8_t catchUp;                  // CATCHUP_xxx policy
+      uint8_t burstCap;                 // max calls per run() with CATCHUP_BURST
+      uint8_t numCalls;                 // calls due in this run() - N.B.: only used in run()
+      unsigned long missedRuns;         // runs missed before this one - N.B.: only used in run()
+#endif
+
+#if ISR_TIMER_DEFERRED
+      bool deferred;                    // true if called by drain() instead of run()
+      uint8_t deferredCall;             // DEFCALL_xxx call queued for drain(), DEFCALL_DONTRUN if not queued
+  #if ISR_TIMER_CATCHUP
+      unsigned long deferredMissedRuns; // runs missed before the call queued for drain()
+  #endif
+#endif
+
+#if ISR_TIMER_PRIORITY
+      uint8_t priority;                 // higher priority callbacks are called first in the same run()
+#endif
+
+#if ISR_TIMER_DEADLINE_MISS
+      unsigned long maxLateness;        // deadline-miss threshold, 0 if disabled
+      uint16_t deadlineMisses;          // number of callbacks started later than maxLateness
+#endif
     } timer_t;
 
     volatile timer_t timer[MAX_TIMERS];
 
+    // callback of each slot, unbound if the slot is free. Not volatile, as TimerDelegate is only called and copied
+    TimerDelegate callbacks[MAX_TIMERS];
+
+#if ISR_TIMER_STATS
+    // fixed-size integer accumulators only, no float in the ISR
+    typedef struct
+    {
+      unsigned long numCalls;
+      unsigned long minExecMicros;
+      unsigned long maxExecMicros;
+      unsigned long totalExecMicros;
+      unsigned long minLatency;
+      unsigned long maxLatency;
+      unsigned long totalLatency;
+    } stats_t;
+
+    volatile stats_t stats[MAX_TIMERS];
+#endif
+
+    // slot numbers, deadlineHeap[0] is the timer to expire first
+    volatile uint8_t deadlineHeap[MAX_TIMERS];
+    volatile uint8_t heapSize;
+
+    // first unused slot, NO_FREE_SLOT if all are used
+    volatile uint8_t freeHead;
+
+#if ISR_TIMER_SLACK
+    // number of timers with a slack. If none, run() doesn't look for timers to coalesce
+    volatile uint8_t numSlackTimers;
+
+    volatile unsigned long wakeupsSaved;
+#endif
+
+    // cached heapDeadline() of deadlineHeap[0], so that a tick with nothing due costs a single compare in run()
+    volatile unsigned long nextDeadline;
+
+#if ISR_TIMER_DEFERRED
+    // Single-producer (run() in the ISR) / single-consumer (drain() in loop()) ring of deferred slot numbers.
+    // A slot is only queued once until drained, so one more entry than the number of timers is enough.
+    // Only run() writes deferredHead and only drain() writes deferredTail, so no critical section is needed
+    const static uint8_t DEFERRED_RING_SIZE = MAX_TIMERS + 1;
+
+    volatile uint8_t deferredRing[DEFERRED_RING_SIZE];
+    volatile uint8_t deferredHead;
+    volatile uint8_t deferredTail;
+#endif
+
+    // tick of the automatic phase spreading, 0 if disabled
+    unsigned long spreadTick;
+
+    // NULL unless in tickless mode
+    timer_tickless_callback ticklessCallback;
+
+#if ISR_TIMER_DEADLINE_MISS
+    // deadline-miss hook, NULL if none
+    timer_miss_callback missCallback;
+#endif
+
     // actual number of timers in use (-1 means uninitialized)
     volatile int numTimers;
 };
 
+// The original 16-timer ISR_Timer
+typedef ISR_TimerN<16>    ISR_Timer;
+
 
 #endif    // #ifndef ISR_TIMER_HPP
@@ -0,0 +1,478 @@
+/****************************************************************************************************************************
+  ISR_TimerWheel-Impl.h
+  For Arduino boards (UNO, Nano, Mega, etc. )
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt
+  Licensed under MIT license
+
+  ISR_TimerWheel is the big brother of ISR_Timer, for sketches needing many more ISR-based timers than 16, such as
+  per-channel watchdogs, retries or LED patterns, while still consuming only 1 hardware Timer.
+  The timers are kept in a hierarchical timing wheel, 4 levels of 16 buckets, so that creating, deleting and ticking
+  all cost the same, whatever the number of timers. Expired timers are processed bucket by bucket.
+  Its run() must be called from the hardware timer ISR at the tick interval given to the constructor.
+
+  Version: 1.8.0
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K Hoang      23/11/2019 Initial coding
+  1.0.1   K Hoang      25/11/2019 New release fixing compiler error
+  1.0.2   K.Hoang      28/11/2019 Permit up to 16 super-long-time, super-accurate ISR-based timers to avoid being blocked
+  1.0.3   K.Hoang      01/12/2020 Add complex examples ISR_16_Timers_Array_Complex and ISR_16_Timers_Array_Complex
+  1.1.1   K.Hoang      06/12/2020 Add example Change_Interval. Bump up version to sync with other TimerInterrupt Libraries
+  1.1.2   K.Hoang      05/01/2021 Fix warnings. Optimize examples to reduce memory usage
+  1.2.0   K.Hoang      07/01/2021 Add better debug feature. Optimize code and examples to reduce RAM usage
+  1.3.0   K.Hoang      25/02/2021 Add support to AVR ATMEGA_32U4 such as Leonardo, YUN, ESPLORA, etc.
+  1.4.0   K.Hoang      01/04/2021 Add support to Adafruit 32U4 and 328(P) such as FEATHER32U4, FEATHER328P, etc.
+  1.4.1   K.Hoang      02/04/2021 Add support to Sparkfun 32U4, 328(P), 128RFA1 such as AVR_PROMICRO, REDBOT, etc.
+  1.5.0   K.Hoang      08/05/2021 Add Timer 3 and 4 to 32U4. Add Timer auto-selection to examples.
+  1.6.0   K.Hoang      15/11/2021 Fix bug resulting half frequency when using high frequencies.
+  1.7.0   K.Hoang      19/11/2021 Fix bug resulting wrong frequency for some frequencies.
+  1.8.0   K.Hoang      18/01/2022 Fix `multiple-definitions` linker error
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef ISR_TIMER_WHEEL_IMPL_H
+#define ISR_TIMER_WHEEL_IMPL_H
+
+#include <string.h>
+
+ISR_TimerWheel::ISR_TimerWheel(unsigned long tickInterval)
+  : tickInterval (tickInterval ? tickInterval : 1), numTimers (-1)
+{
+}
+
+void ISR_TimerWheel::init()
+{
+  for (uint8_t i = 0; i < WHEEL_LEVELS * WHEEL_SIZE; i++)
+  {
+    bucketHead[i] = NIL;
+  }
+
+  for (wheel_index_t i = 0; i < MAX_TIMERS; i++)
+  {
+    memset((void*) &timer[i], 0, sizeof (wheel_timer_t));
+    callbacks[i]    = TimerDelegate();
+    timer[i].bucket = NOT_IN_WHEEL;
+    timer[i].next   = (i + 1 < MAX_TIMERS) ? i + 1 : NIL;
+  }
+
+  freeHead    = 0;
+  currentTick = 0;
+  numTimers   = 0;
+}
+
+unsigned long ISR_TimerWheel::msToTicks(unsigned long d)
+{
+  unsigned long ticks = (d + tickInterval / 2) / tickInterval;
+
+  return ticks ? ticks : 1;
+}
+
+void ISR_TimerWheel::linkTimer(wheel_index_t numTimer)
+{
+  unsigned long expires = timer[numTimer].expires;
+  unsigned long delta   = expires - currentTick;
+  uint8_t level = 0;
+
+  if (delta > WHEEL_RANGE)
+  {
+    // Too far away, park it in the top level bucket cascading last. It'll be re-placed from there
+    expires = currentTick + WHEEL_RANGE;
+    delta   = WHEEL_RANGE;
+  }
+
+  while (delta >= WHEEL_SIZE)
+  {
+    delta >>= WHEEL_BITS;
+    level++;
+  }
+
+  uint8_t bucket = level * WHEEL_SIZE + ( (expires >> (level * WHEEL_BITS)) & WHEEL_MASK );
+  wheel_index_t head = bucketHead[bucket];
+
+  timer[numTimer].bucket = bucket;
+  timer[numTimer].prev   = NIL;
+  timer[numTimer].next   = head;
+
+  if (head != NIL)
+    timer[head].prev = numTimer;
+
+  bucketHead[bucket] = numTimer;
+}
+
+void ISR_TimerWheel::unlinkTimer(wheel_index_t numTimer)
+{
+  uint8_t bucket = timer[numTimer].bucket;
+
+  if (bucket == NOT_IN_WHEEL)
+    return;
+
+  wheel_index_t next = timer[numTimer].next;
+  wheel_index_t prev = timer[numTimer].prev;
+
+  if (prev != NIL)
+    timer[prev].next = next;
+  else
+    bucketHead[bucket] = next;
+
+  if (next != NIL)
+    timer[next].prev = prev;
+
+  timer[numTimer].bucket = NOT_IN_WHEEL;
+}
+
+void ISR_TimerWheel::cascade(uint8_t level, uint8_t index)
+{
+  uint8_t bucket = level * WHEEL_SIZE + index;
+  wheel_index_t i = bucketHead[bucket];
+
+  bucketHead[bucket] = NIL;
+
+  // all of them are now less than one turn of this level away, so they land in lower levels
+  // (or back to the top level for the parked ones)
+  while (i != NIL)
+  {
+    wheel_index_t next = timer[i].next;
+
+    linkTimer(i);
+    i = next;
+  }
+}
+
+void ISR_TimerWheel::run()
+{
+  wheel_index_t i;
+  wheel_index_t dueHead = NIL;
+  wheel_index_t dueTail = NIL;
+
+  unsigned long tick = ++currentTick;
+
+  // lower level buckets are empty at each turn, refill them from the next level
+  for (uint8_t level = 1; level < WHEEL_LEVELS; level++)
+  {
+    if ( ( tick & ( (1UL << (level * WHEEL_BITS)) - 1 ) ) != 0 )
+      break;
+
+    cascade(level, (tick >> (level * WHEEL_BITS)) & WHEEL_MASK);
+  }
+
+  // every timer in the current level 0 bucket is due now
+  uint8_t bucket = tick & WHEEL_MASK;
+
+  i = bucketHead[bucket];
+  bucketHead[bucket] = NIL;
+
+  while (i != NIL)
+  {
+    wheel_index_t next = timer[i].next;
+
+    timer[i].bucket     = NOT_IN_WHEEL;
+    timer[i].toBeCalled = DEFCALL_DONTRUN;
+
+    // check if the timer callback has to be executed
+    if (timer[i].enabled)
+    {
+      // "run forever" timers must always be executed
+      if (timer[i].maxNumRuns == RUN_FOREVER)
+      {
+        timer[i].toBeCalled = DEFCALL_RUNONLY;
+      }
+      // other timers get executed the specified number of times
+      else if (timer[i].numRuns < timer[i].maxNumRuns)
+      {
+        timer[i].toBeCalled = DEFCALL_RUNONLY;
+        timer[i].numRuns++;
+
+        // after the last run, delete the timer
+        if (timer[i].numRuns >= timer[i].maxNumRuns)
+        {
+          timer[i].toBeCalled = DEFCALL_RUNANDDEL;
+        }
+      }
+    }
+
+    if (timer[i].toBeCalled != DEFCALL_RUNANDDEL)
+    {
+      timer[i].expires += timer[i].period;
+      linkTimer(i);
+    }
+
+    if (timer[i].toBeCalled != DEFCALL_DONTRUN)
+    {
+      timer[i].nextDue = NIL;
+
+      if (dueTail == NIL)
+        dueHead = i;
+      else
+        timer[dueTail].nextDue = i;
+
+      dueTail = i;
+    }
+
+    i = next;
+  }
+
+  // Then call the due ones. Callbacks can create or delete timers, deleteTimer() keeps nextDue
+  for (i = dueHead; i != NIL; i = timer[i].nextDue)
+  {
+    // the timer can have been deleted by a previous callback
+    if (timer[i].toBeCalled == DEFCALL_DONTRUN)
+      continue;
+
+    callbacks[i]();
+
+    if (timer[i].toBeCalled == DEFCALL_RUNANDDEL)
+    {
+      ISR_TIMER_ENTER_CRITICAL();
+
+      deleteSlot(i);
+
+      ISR_TIMER_EXIT_CRITICAL();
+    }
+    else
+      timer[i].toBeCalled = DEFCALL_DONTRUN;
+  }
+}
+
+int ISR_TimerWheel::setupTimer(unsigned long d, const TimerDelegate& f, unsigned n)
+{
+  wheel_index_t freeTimer;
+
+  if (numTimers < 0)
+  {
+    init();
+  }
+
+  if (!f.isBound())
+  {
+    return -1;
+  }
+
+  ISR_TIMER_ENTER_CRITICAL();
+
+  freeTimer = freeHead;
+
+  if (freeTimer == NIL)
+  {
+    ISR_TIMER_EXIT_CRITICAL();
+
+    return -1;
+  }
+
+  freeHead = timer[freeTimer].next;
+
+  timer[freeTimer].period       = msToTicks(d);
+  timer[freeTimer].expires      = currentTick + timer[freeTimer].period;
+  callbacks[freeTimer]          = f;
+  timer[freeTimer].maxNumRuns   = n;
+  timer[freeTimer].numRuns      = 0;
+  timer[freeTimer].enabled      = true;
+  timer[freeTimer].toBeCalled   = DEFCALL_DONTRUN;
+
+  linkTimer(freeTimer);
+
+  numTimers++;
+
+  ISR_TIMER_EXIT_CRITICAL();
+
+  return (timer[freeTimer].generation << HANDLE_SLOT_BITS) | freeTimer;
+}
+
+// slot of a timer handle, -1 if out of range, unused, or stale (its timer was deleted).
+// Called within ISR_TIMER_ENTER_CRITICAL(), held until the slot is used, so that run() can't free it in between
+int ISR_TimerWheel::slotOf(unsigned numTimer)
+{
+  wheel_index_t slot = numTimer & HANDLE_SLOT_MASK;
+
+  if ( (slot >= MAX_TIMERS) || ( (numTimer >> HANDLE_SLOT_BITS) != timer[slot].generation ) || (!callbacks[slot].isBound()) )
+  {
+    return -1;
+  }
+
+  return slot;
+}
+
+int ISR_TimerWheel::setTimer(unsigned long d, timer_callback f, unsigned n)
+{
+  return setupTimer(d, TimerDelegate(f), n);
+}
+
+int ISR_TimerWheel::setTimer(unsigned long d, timer_callback_p f, void* p, unsigned n)
+{
+  return setupTimer(d, TimerDelegate(f, p), n);
+}
+
+int ISR_TimerWheel::setInterval(unsigned long d, timer_callback f)
+{
+  return setupTimer(d, TimerDelegate(f), RUN_FOREVER);
+}
+
+int ISR_TimerWheel::setInterval(unsigned long d, timer_callback_p f, void* p)
+{
+  return setupTimer(d, TimerDelegate(f, p), RUN_FOREVER);
+}
+
+int ISR_TimerWheel::setTimeout(unsigned long d, timer_callback f)
+{
+  return setupTimer(d, TimerDelegate(f), RUN_ONCE);
+}
+
+int ISR_TimerWheel::setTimeout(unsigned long d, timer_callback_p f, void* p)
+{
+  return setupTimer(d, TimerDelegate(f, p), RUN_ONCE);
+}
+
+int ISR_TimerWheel::setInterval(unsigned long d, const TimerDelegate& f)
+{
+  return setupTimer(d, f, RUN_FOREVER);
+}
+
+int ISR_TimerWheel::setTimeout(unsigned long d, const TimerDelegate& f)
+{
+  return setupTimer(d, f, RUN_ONCE);
+}
+
+int ISR_TimerWheel::setTimer(unsigned long d, const TimerDelegate& f, unsigned n)
+{
+  return setupTimer(d, f, n);
+}
+
+bool ISR_TimerWheel::changeInterval(unsigned numTimer, unsigned long d)
+{
+  ISR_TIMER_ENTER_CRITICAL();
+
+  int slot = slotOf(numTimer);
+
+  // false return for non-used or stale numTimer
+  if (slot < 0)
+  {
+    ISR_TIMER_EXIT_CRITICAL();
+
+    return false;
+  }
+
+  // Updates interval of existing specified timer
+  timer[slot].period  = msToTicks(d);
+  timer[slot].expires = currentTick + timer[slot].period;
+
+  // a one-shot timer being called now isn't in the wheel, and mustn't be put back
+  if (timer[slot].bucket != NOT_IN_WHEEL)
+  {
+    unlinkTimer(slot);
+    linkTimer(slot);
+  }
+
+  ISR_TIMER_EXIT_CRITICAL();
+
+  return true;
+}
+
+void ISR_TimerWheel::deleteTimer(unsigned numTimer)
+{
+  ISR_TIMER_ENTER_CRITICAL();
+
+  int slot = slotOf(numTimer);
+
+  if (slot < 0)
+  {
+    ISR_TIMER_EXIT_CRITICAL();
+
+    return;
+  }
+
+  deleteSlot(slot);
+
+  ISR_TIMER_EXIT_CRITICAL();
+}
+
+void ISR_TimerWheel::deleteSlot(wheel_index_t slot)
+{
+  // nothing to delete if the specified slot is already empty, so that it isn't
+  // pushed twice on the free list
+  if ( (numTimers <= 0) || (!callbacks[slot].isBound()) )
+  {
+    return;
+  }
+
+  unlinkTimer(slot);
+
+  // nextDue is kept, run() may be walking through it
+  callbacks[slot]         = TimerDelegate();
+  timer[slot].enabled     = false;
+  timer[slot].toBeCalled  = DEFCALL_DONTRUN;
+
+  // handles of the deleted timer become stale
+  timer[slot].generation  = (timer[slot].generation + 1) & GENERATION_MASK;
+
+  timer[slot].next = freeHead;
+  freeHead = slot;
+
+  // update number of timers
+  numTimers--;
+}
+
+bool ISR_TimerWheel::isEnabled(unsigned numTimer)
+{
+  ISR_TIMER_ENTER_CRITICAL();
+
+  int slot = slotOf(numTimer);
+
+  if (slot < 0)
+  {
+    ISR_TIMER_EXIT_CRITICAL();
+
+    return false;
+  }
+
+  bool enabled = timer[slot].enabled;
+
+  ISR_TIMER_EXIT_CRITICAL();
+
+  return enabled;
+}
+
+void ISR_TimerWheel::enable(unsigned numTimer)
+{
+  ISR_TIMER_ENTER_CRITICAL();
+
+  int slot = slotOf(numTimer);
+
+  if (slot < 0)
+  {
+    ISR_TIMER_EXIT_CRITICAL();
+
+    return;
+  }
+
+  timer[slot].enabled = true;
+
+  ISR_TIMER_EXIT_CRITICAL();
+}
+
+void ISR_TimerWheel::disable(unsigned numTimer)
+{
+  ISR_TIMER_ENTER_CRITICAL();
+
+  int slot = slotOf(numTimer);
+
+  if (slot < 0)
+  {
+    ISR_TIMER_EXIT_CRITICAL();
+
+    return;
+  }
+
+  timer[slot].enabled = false;
+
+  ISR_TIMER_EXIT_CRITICAL();
+}
+
+unsigned ISR_TimerWheel::getNumTimers()
+{
+  return numTimers;
+}
+
+#endif  // ISR_TIMER_WHEEL_IMPL_H
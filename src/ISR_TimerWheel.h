@@ -0,0 +1,43 @@
+/****************************************************************************************************************************
+  ISR_TimerWheel.h
+  For Arduino boards (UNO, Nano, Mega, etc. )
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt
+  Licensed under MIT license
+
+  ISR_TimerWheel is the big brother of ISR_Timer, for sketches needing many more ISR-based timers than 16, such as
+  per-channel watchdogs, retries or LED patterns, while still consuming only 1 hardware Timer.
+  The timers are kept in a hierarchical timing wheel, 4 levels of 16 buckets, so that creating, deleting and ticking
+  all cost the same, whatever the number of timers. Expired timers are processed bucket by bucket.
+  Its run() must be called from the hardware timer ISR at the tick interval given to the constructor.
+
+  Version: 1.8.0
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K Hoang      23/11/2019 Initial coding
+  1.0.1   K Hoang      25/11/2019 New release fixing compiler error
+  1.0.2   K.Hoang      28/11/2019 Permit up to 16 super-long-time, super-accurate ISR-based timers to avoid being blocked
+  1.0.3   K.Hoang      01/12/2020 Add complex examples ISR_16_Timers_Array_Complex and ISR_16_Timers_Array_Complex
+  1.1.1   K.Hoang      06/12/2020 Add example Change_Interval. Bump up version to sync with other TimerInterrupt Libraries
+  1.1.2   K.Hoang      05/01/2021 Fix warnings. Optimize examples to reduce memory usage
+  1.2.0   K.Hoang      07/01/2021 Add better debug feature. Optimize code and examples to reduce RAM usage
+  1.3.0   K.Hoang      25/02/2021 Add support to AVR ATMEGA_32U4 such as Leonardo, YUN, ESPLORA, etc.
+  1.4.0   K.Hoang      01/04/2021 Add support to Adafruit 32U4 and 328(P) such as FEATHER32U4, FEATHER328P, etc.
+  1.4.1   K.Hoang      02/04/2021 Add support to Sparkfun 32U4, 328(P), 128RFA1 such as AVR_PROMICRO, REDBOT, etc.
+  1.5.0   K.Hoang      08/05/2021 Add Timer 3 and 4 to 32U4. Add Timer auto-selection to examples.
+  1.6.0   K.Hoang      15/11/2021 Fix bug resulting half frequency when using high frequencies.
+  1.7.0   K.Hoang      19/11/2021 Fix bug resulting wrong frequency for some frequencies.
+  1.8.0   K.Hoang      18/01/2022 Fix `multiple-definitions` linker error
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef ISR_TIMER_WHEEL_H
+#define ISR_TIMER_WHEEL_H
+
+#include "ISR_TimerWheel.hpp"
+#include "ISR_TimerWheel-Impl.h"
+
+#endif
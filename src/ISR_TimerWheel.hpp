@@ -0,0 +1,232 @@
+/****************************************************************************************************************************
+  ISR_TimerWheel.hpp
+  For Arduino boards (UNO, Nano, Mega, etc. )
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt
+  Licensed under MIT license
+
+  ISR_TimerWheel is the big brother of ISR_Timer, for sketches needing many more ISR-based timers than 16, such as
+  per-channel watchdogs, retries or LED patterns, while still consuming only 1 hardware Timer.
+  The timers are kept in a hierarchical timing wheel, 4 levels of 16 buckets, so that creating, deleting and ticking
+  all cost the same, whatever the number of timers. Expired timers are processed bucket by bucket.
+  Its run() must be called from the hardware timer ISR at the tick interval given to the constructor.
+
+  Version: 1.8.0
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K Hoang      23/11/2019 Initial coding
+  1.0.1   K Hoang      25/11/2019 New release fixing compiler error
+  1.0.2   K.Hoang      28/11/2019 Permit up to 16 super-long-time, super-accurate ISR-based timers to avoid being blocked
+  1.0.3   K.Hoang      01/12/2020 Add complex examples ISR_16_Timers_Array_Complex and ISR_16_Timers_Array_Complex
+  1.1.1   K.Hoang      06/12/2020 Add example Change_Interval. Bump up version to sync with other TimerInterrupt Libraries
+  1.1.2   K.Hoang      05/01/2021 Fix warnings. Optimize examples to reduce memory usage
+  1.2.0   K.Hoang      07/01/2021 Add better debug feature. Optimize code and examples to reduce RAM usage
+  1.3.0   K.Hoang      25/02/2021 Add support to AVR ATMEGA_32U4 such as Leonardo, YUN, ESPLORA, etc.
+  1.4.0   K.Hoang      01/04/2021 Add support to Adafruit 32U4 and 328(P) such as FEATHER32U4, FEATHER328P, etc.
+  1.4.1   K.Hoang      02/04/2021 Add support to Sparkfun 32U4, 328(P), 128RFA1 such as AVR_PROMICRO, REDBOT, etc.
+  1.5.0   K.Hoang      08/05/2021 Add Timer 3 and 4 to 32U4. Add Timer auto-selection to examples.
+  1.6.0   K.Hoang      15/11/2021 Fix bug resulting half frequency when using high frequencies.
+  1.7.0   K.Hoang      19/11/2021 Fix bug resulting wrong frequency for some frequencies.
+  1.8.0   K.Hoang      18/01/2022 Fix `multiple-definitions` linker error
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef ISR_TIMER_WHEEL_HPP
+#define ISR_TIMER_WHEEL_HPP
+
+// For TimerDelegate and ISR_TIMER_ENTER_CRITICAL() / ISR_TIMER_EXIT_CRITICAL()
+#include "ISR_Timer.hpp"
+
+// Number of timers, fixed at compile time, up to 254. Each one uses around 29 bytes of RAM
+#ifndef ISR_TIMER_WHEEL_MAX_TIMERS
+  #if ( defined(__AVR_ATmega2560__) || defined(__AVR_ATmega2561__) || defined(__AVR_ATmega1280__) || defined(__AVR_ATmega1281__) )
+    #define ISR_TIMER_WHEEL_MAX_TIMERS        128
+  #else
+    #define ISR_TIMER_WHEEL_MAX_TIMERS        32
+  #endif
+#endif
+
+// Timer handles (numTimer) are the same as the ones of ISR_TimerN, the slot number plus a generation counter bumped
+// each time the slot is freed, so that a stale handle doesn't act on another timer reusing the slot
+class ISR_TimerWheel
+{
+  static_assert(ISR_TIMER_WHEEL_MAX_TIMERS < 255, "ISR_TIMER_WHEEL_MAX_TIMERS must be 1 to 254 timers");
+
+  public:
+    // maximum number of timers
+    const static int MAX_TIMERS = ISR_TIMER_WHEEL_MAX_TIMERS;
+
+    // setTimer() constants
+    const static int RUN_FOREVER = 0;
+    const static int RUN_ONCE = 1;
+
+    // constructor. tickInterval (in milliseconds) is the interval of the hardware timer calling run()
+    explicit ISR_TimerWheel(unsigned long tickInterval = 1);
+
+    void  init();
+
+    // this function must be called from the hardware timer ISR, once every tickInterval
+    void  run();
+
+    // Timer will call function 'f' every 'd' milliseconds forever
+    // returns the timer number (numTimer) on success or
+    // -1 on failure (f == NULL) or no free timers
+    int setInterval(unsigned long d, timer_callback f);
+
+    // Timer will call function 'f' with parameter 'p' every 'd' milliseconds forever
+    // returns the timer number (numTimer) on success or
+    // -1 on failure (f == NULL) or no free timers
+    int setInterval(unsigned long d, timer_callback_p f, void* p);
+
+    // Timer will call TimerDelegate 'f', such as a member function, every 'd' milliseconds forever
+    // returns the timer number (numTimer) on success or
+    // -1 on failure (f unbound) or no free timers
+    int setInterval(unsigned long d, const TimerDelegate& f);
+
+    // Timer will call function 'f' after 'd' milliseconds one time
+    // returns the timer number (numTimer) on success or
+    // -1 on failure (f == NULL) or no free timers
+    int setTimeout(unsigned long d, timer_callback f);
+
+    // Timer will call function 'f' with parameter 'p' after 'd' milliseconds one time
+    // returns the timer number (numTimer) on success or
+    // -1 on failure (f == NULL) or no free timers
+    int setTimeout(unsigned long d, timer_callback_p f, void* p);
+
+    // Timer will call TimerDelegate 'f' after 'd' milliseconds one time
+    // returns the timer number (numTimer) on success or
+    // -1 on failure (f unbound) or no free timers
+    int setTimeout(unsigned long d, const TimerDelegate& f);
+
+    // Timer will call function 'f' every 'd' milliseconds 'n' times
+    // returns the timer number (numTimer) on success or
+    // -1 on failure (f == NULL) or no free timers
+    int setTimer(unsigned long d, timer_callback f, unsigned n);
+
+    // Timer will call function 'f' with parameter 'p' every 'd' milliseconds 'n' times
+    // returns the timer number (numTimer) on success or
+    // -1 on failure (f == NULL) or no free timers
+    int setTimer(unsigned long d, timer_callback_p f, void* p, unsigned n);
+
+    // Timer will call TimerDelegate 'f' every 'd' milliseconds 'n' times
+    // returns the timer number (numTimer) on success or
+    // -1 on failure (f unbound) or no free timers
+    int setTimer(unsigned long d, const TimerDelegate& f, unsigned n);
+
+    // updates interval of the specified timer, and restarts it from now
+    bool changeInterval(unsigned numTimer, unsigned long d);
+
+    // destroy the specified timer
+    void deleteTimer(unsigned numTimer);
+
+    // returns true if the specified timer is enabled
+    bool isEnabled(unsigned numTimer);
+
+    // enables the specified timer
+    void enable(unsigned numTimer);
+
+    // disables the specified timer
+    void disable(unsigned numTimer);
+
+    // returns the number of used timers
+    unsigned  getNumTimers();
+
+    // returns the number of available timers
+    unsigned  getNumAvailableTimers()
+    {
+      return MAX_TIMERS - numTimers;
+    };
+
+  private:
+
+    // 4 levels of 16 buckets => timers up to 65535 ticks away are placed directly.
+    // Longer ones are parked in the last bucket of the top level and re-placed when it cascades
+    const static uint8_t WHEEL_BITS   = 4;
+    const static uint8_t WHEEL_SIZE   = (1 << WHEEL_BITS);
+    const static uint8_t WHEEL_MASK   = WHEEL_SIZE - 1;
+    const static uint8_t WHEEL_LEVELS = 4;
+
+    // max ticks from now a timer can be placed at
+    const static unsigned long WHEEL_RANGE = (1UL << (WHEEL_BITS * WHEEL_LEVELS)) - 1;
+
+    typedef uint8_t   wheel_index_t;
+
+    // end of list
+    const static wheel_index_t NIL = (wheel_index_t) -1;
+
+    // bucket of a timer not in the wheel
+    const static uint8_t NOT_IN_WHEEL = 0xFF;
+
+    // deferred call constants
+    const static uint8_t DEFCALL_DONTRUN = 0;       // don't call the callback function
+    const static uint8_t DEFCALL_RUNONLY = 1;       // call the callback function but don't delete the timer
+    const static uint8_t DEFCALL_RUNANDDEL = 2;     // call the callback function and delete the timer
+
+    // timer handle = (generation << HANDLE_SLOT_BITS) | slot, always positive in an int, as for ISR_TimerN
+    const static uint8_t HANDLE_SLOT_BITS = 8;
+    const static uint8_t HANDLE_SLOT_MASK = 0xFF;
+    const static uint8_t GENERATION_MASK  = 0x7F;
+
+    // low level function to initialize and enable a new timer
+    // returns the timer number (numTimer) on success or
+    // -1 on failure (f unbound) or no free timers
+    int  setupTimer(unsigned long d, const TimerDelegate& f, unsigned n);
+
+    // slot of a timer handle, -1 if stale or invalid. Within ISR_TIMER_ENTER_CRITICAL()
+    int  slotOf(unsigned numTimer);
+
+    // destroy the timer in the specified slot, if still used. Within ISR_TIMER_ENTER_CRITICAL()
+    void deleteSlot(wheel_index_t slot);
+
+    // convert milliseconds to ticks, at least 1 tick
+    unsigned long msToTicks(unsigned long d);
+
+    // link the timer into the bucket matching its expires, relative to currentTick
+    void linkTimer(wheel_index_t numTimer);
+
+    // unlink the timer from its bucket
+    void unlinkTimer(wheel_index_t numTimer);
+
+    // re-place all the timers of a higher level bucket into the lower levels
+    void cascade(uint8_t level, uint8_t index);
+
+    typedef struct
+    {
+      unsigned long expires;            // tick at which the timer is due
+      unsigned long period;             // interval in ticks
+      wheel_index_t next;               // next timer in the same bucket, or in the free list
+      wheel_index_t prev;               // previous timer in the same bucket
+      wheel_index_t nextDue;            // next timer to be called in run()
+      uint8_t bucket;                   // level * WHEEL_SIZE + index, NOT_IN_WHEEL if not linked
+      uint8_t generation;               // generation of the handle, incremented when the slot is freed
+      bool enabled;                     // true if enabled
+      uint8_t toBeCalled;               // deferred function call - N.B.: only used in run()
+      unsigned maxNumRuns;              // number of runs to be executed
+      unsigned numRuns;                 // number of executed runs
+    } wheel_timer_t;
+
+    volatile wheel_timer_t timer[MAX_TIMERS];
+
+    // callback of each slot, unbound if the slot is free. Not volatile, as TimerDelegate is only called and copied
+    TimerDelegate callbacks[MAX_TIMERS];
+
+    // first timer of each bucket
+    volatile wheel_index_t bucketHead[WHEEL_LEVELS * WHEEL_SIZE];
+
+    // unused timers, chained through next
+    volatile wheel_index_t freeHead;
+
+    // number of run() calls since init()
+    volatile unsigned long currentTick;
+
+    // interval in milliseconds between 2 run() calls
+    unsigned long tickInterval;
+
+    // actual number of timers in use (-1 means uninitialized)
+    volatile int numTimers;
+};
+
+#endif    // #ifndef ISR_TIMER_WHEEL_HPP
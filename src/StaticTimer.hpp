@@ -0,0 +1,167 @@
+/****************************************************************************************************************************
+  StaticTimer.hpp
+  For Arduino boards (UNO, Nano, Mega, etc. )
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt
+  Licensed under MIT license
+
+  StaticTimer<TimerNo, Hz> is the compile-time front end of TimerInterrupt, for fixed-rate control loops.
+  The prescaler and OCR are computed by the compiler, with the same smallest-error rule as TimerInterrupt::setFrequency(),
+  so attach() is only a few register writes, and the only RAM used is the callback pointer.
+  Frequencies out of the range of the timer, with one compare per period, are rejected at compile time.
+
+  Version: 1.8.0
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K Hoang      23/11/2019 Initial coding
+  1.0.1   K Hoang      25/11/2019 New release fixing compiler error
+  1.0.2   K.Hoang      28/11/2019 Permit up to 16 super-long-time, super-accurate ISR-based timers to avoid being blocked
+  1.0.3   K.Hoang      01/12/2020 Add complex examples ISR_16_Timers_Array_Complex and ISR_16_Timers_Array_Complex
+  1.1.1   K.Hoang      06/12/2020 Add example Change_Interval. Bump up version to sync with other TimerInterrupt Libraries
+  1.1.2   K.Hoang      05/01/2021 Fix warnings. Optimize examples to reduce memory usage
+  1.2.0   K.Hoang      07/01/2021 Add better debug feature. Optimize code and examples to reduce RAM usage
+  1.3.0   K.Hoang      25/02/2021 Add support to AVR ATMEGA_32U4 such as Leonardo, YUN, ESPLORA, etc.
+  1.4.0   K.Hoang      01/04/2021 Add support to Adafruit 32U4 and 328(P) such as FEATHER32U4, FEATHER328P, etc.
+  1.4.1   K.Hoang      02/04/2021 Add support to Sparkfun 32U4, 328(P), 128RFA1 such as AVR_PROMICRO, REDBOT, etc.
+  1.5.0   K.Hoang      08/05/2021 Add Timer 3 and 4 to 32U4. Add Timer auto-selection to examples.
+  1.6.0   K.Hoang      15/11/2021 Fix bug resulting half frequency when using high frequencies.
+  1.7.0   K.Hoang      19/11/2021 Fix bug resulting wrong frequency for some frequencies.
+  1.8.0   K.Hoang      18/01/2022 Fix `multiple-definitions` linker error
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef STATIC_TIMER_HPP
+#define STATIC_TIMER_HPP
+
+// For the board checks, prescaler indexes, timer_callback and TimerRegisters
+#include "TimerInterrupt.hpp"
+
+// Callback of each hardware timer, called by its ISR in StaticTimer.h
+template<uint8_t TimerNo>
+struct StaticTimerCallback
+{
+  static timer_callback callback;
+};
+
+template<uint8_t TimerNo>
+timer_callback StaticTimerCallback<TimerNo>::callback = NULL;
+
+// Such as StaticTimer<1, 10000>::attach(handler), with USE_STATIC_TIMER_1 true before #include "StaticTimer.h"
+template<uint8_t TimerNo, uint32_t Hz>
+class StaticTimer
+{
+  private:
+
+    static constexpr bool isAvailable()
+    {
+      return
+#if TIMER_REGISTERS_1 && defined(WGM12)
+        (TimerNo == 1) ||
+#endif
+#if TIMER_REGISTERS_2 && defined(WGM21)
+        (TimerNo == 2) ||
+#endif
+#if TIMER_REGISTERS_3 && defined(WGM32)
+        (TimerNo == 3) ||
+#endif
+#if TIMER_REGISTERS_4 && defined(WGM42) && !TIMER_INTERRUPT_USING_ATMEGA_32U4
+        // The 10-bit Timer4 of ATmega32U4 has its own registers
+        (TimerNo == 4) ||
+#endif
+#if TIMER_REGISTERS_5 && defined(WGM52)
+        (TimerNo == 5) ||
+#endif
+        false;
+    }
+
+    static constexpr uint32_t maxCount()
+    {
+      return (TimerNo == 2) ? MAX_COUNT_8BIT : MAX_COUNT_16BIT;
+    }
+
+    static constexpr uint8_t firstIndex()
+    {
+      return (TimerNo == 2) ? (uint8_t) T2_NO_PRESCALER : (uint8_t) NO_PRESCALER;
+    }
+
+    static constexpr uint8_t lastIndex()
+    {
+      return (TimerNo == 2) ? (uint8_t) T2_PRESCALER_1024 : (uint8_t) PRESCALER_1024;
+    }
+
+    // Same as prescalerDiv[] and prescalerDivT2[], usable at compile time
+    static constexpr uint32_t divOf(uint8_t index)
+    {
+      return (TimerNo == 2) ?
+             ( (index == T2_PRESCALER_8) ? 8 : (index == T2_PRESCALER_32) ? 32 : (index == T2_PRESCALER_64) ? 64 :
+               (index == T2_PRESCALER_128) ? 128 : (index == T2_PRESCALER_256) ? 256 : (index == T2_PRESCALER_1024) ? 1024 : 1 ) :
+             ( (index == PRESCALER_8) ? 8 : (index == PRESCALER_64) ? 64 : (index == PRESCALER_256) ? 256 :
+               (index == PRESCALER_1024) ? 1024 : 1 );
+    }
+
+    // counts of one period, rounded
+    static constexpr uint64_t countsOf(uint8_t index)
+    {
+      return (Hz == 0) ? 0 : ((uint64_t) F_CPU + (uint64_t) Hz * divOf(index) / 2) / ((uint64_t) Hz * divOf(index));
+    }
+
+    static constexpr bool fits(uint8_t index)
+    {
+      return (countsOf(index) >= 1) && (countsOf(index) <= maxCount() + 1);
+    }
+
+    // error, in 1 / Hz CPU cycle
+    static constexpr uint64_t errorOf(uint8_t index)
+    {
+      return (countsOf(index) * divOf(index) * Hz > (uint64_t) F_CPU) ? countsOf(index) * divOf(index) * Hz - F_CPU :
+             F_CPU - countsOf(index) * divOf(index) * Hz;
+    }
+
+    // Smallest error among the fitting prescalers, the larger one on a tie
+    static constexpr uint8_t bestIndex(uint8_t index, uint8_t best)
+    {
+      return (index > lastIndex()) ? best :
+             bestIndex(index + 1, ( fits(index) && ( !fits(best) || (errorOf(index) <= errorOf(best)) ) ) ? index : best);
+    }
+
+  public:
+
+    // CSx2:0 bits, same as TimerInterrupt _prescalerIndex
+    static constexpr uint8_t  PRESCALER_INDEX = bestIndex(firstIndex(), firstIndex());
+    static constexpr uint16_t OCR_VALUE       = countsOf(PRESCALER_INDEX) - 1;
+
+    static_assert(isAvailable(), "StaticTimer TimerNo isn't available on this board. Timer0 is used by millis()");
+    static_assert(Hz > 0, "StaticTimer Hz must be > 0");
+    static_assert(fits(PRESCALER_INDEX), "StaticTimer Hz out of range, too low or too high for one compare of this timer");
+
+    // Restart the timer in CTC mode at Hz, and call callback from its compare interrupt.
+    // Returns false if callback is NULL
+    static bool attach(timer_callback callback)
+    {
+      if (callback == NULL)
+        return false;
+
+      uint8_t sregSaved = SREG;
+      noInterrupts();
+
+      StaticTimerCallback<TimerNo>::callback = callback;
+
+      // Stop the clock, load the count, clear any stale compare flag (by writing 1), then start with the prescaler
+      TimerRegisters<TimerNo>::startCTC(PRESCALER_INDEX, OCR_VALUE);
+
+      SREG = sregSaved;
+
+      return true;
+    }
+
+    // Disable the compare interrupt, the timer keeps counting
+    static void detach()
+    {
+      TimerRegisters<TimerNo>::disableInterrupt();
+    }
+};
+
+#endif    // #ifndef STATIC_TIMER_HPP
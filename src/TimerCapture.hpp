@@ -0,0 +1,210 @@
+/****************************************************************************************************************************
+  TimerCapture.hpp
+  For Arduino boards (UNO, Nano, Mega, etc. )
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt
+  Licensed under MIT license
+
+  TimerCapture<TimerNo> measures periods with the Input Capture unit of a 16-bit timer, ICP1, ICP3, ICP4 or ICP5.
+  The timer runs free, the hardware latches TCNTn into ICRn on each selected edge, and the overflows extend it to 32 bits,
+  so the period is in timer ticks, at CPU clock resolution without prescaler, with only one interrupt per edge.
+  Version: 1.8.0
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K Hoang      23/11/2019 Initial coding
+  1.0.1   K Hoang      25/11/2019 New release fixing compiler error
+  1.0.2   K.Hoang      28/11/2019 Permit up to 16 super-long-time, super-accurate ISR-based timers to avoid being blocked
+  1.0.3   K.Hoang      01/12/2020 Add complex examples ISR_16_Timers_Array_Complex and ISR_16_Timers_Array_Complex
+  1.1.1   K.Hoang      06/12/2020 Add example Change_Interval. Bump up version to sync with other TimerInterrupt Libraries
+  1.1.2   K.Hoang      05/01/2021 Fix warnings. Optimize examples to reduce memory usage
+  1.2.0   K.Hoang      07/01/2021 Add better debug feature. Optimize code and examples to reduce RAM usage
+  1.3.0   K.Hoang      25/02/2021 Add support to AVR ATMEGA_32U4 such as Leonardo, YUN, ESPLORA, etc.
+  1.4.0   K.Hoang      01/04/2021 Add support to Adafruit 32U4 and 328(P) such as FEATHER32U4, FEATHER328P, etc.
+  1.4.1   K.Hoang      02/04/2021 Add support to Sparkfun 32U4, 328(P), 128RFA1 such as AVR_PROMICRO, REDBOT, etc.
+  1.5.0   K.Hoang      08/05/2021 Add Timer 3 and 4 to 32U4. Add Timer auto-selection to examples.
+  1.6.0   K.Hoang      15/11/2021 Fix bug resulting half frequency when using high frequencies.
+  1.7.0   K.Hoang      19/11/2021 Fix bug resulting wrong frequency for some frequencies.
+  1.8.0   K.Hoang      18/01/2022 Fix `multiple-definitions` linker error
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef TIMER_CAPTURE_HPP
+#define TIMER_CAPTURE_HPP
+
+// For the board checks, prescaler indexes and TimerRegisters
+#include "TimerInterrupt.hpp"
+
+enum
+{
+  CAPTURE_FALLING = 0,
+  CAPTURE_RISING
+};
+
+// Called from the capture interrupt with the period, in timer ticks, since the previous edge
+typedef void (*timer_capture_callback)(uint32_t periodTicks);
+
+// Such as TimerCapture<1>::begin(CAPTURE_RISING), with USE_TIMER_CAPTURE_1 true before #include "TimerCapture.h"
+template<uint8_t TimerNo>
+class TimerCapture
+{
+  private:
+
+    static volatile uint16_t  _overflows;         // high word of the 32-bit count
+    static volatile uint16_t  _idleOverflows;     // overflows since the last edge
+    static volatile uint32_t  _lastCapture;
+    static volatile uint32_t  _period;            // 0 => no period measured yet
+    static volatile uint8_t   _numEdges;          // up to 2
+    static volatile bool      _isNewPeriod;
+    static uint8_t            _prescalerIndex;
+    static timer_capture_callback _callback;
+
+    static constexpr bool isAvailable()
+    {
+      return
+#if TIMER_REGISTERS_1 && defined(ICR1) && defined(TIMSK1) && defined(ICIE1)
+        (TimerNo == 1) ||
+#endif
+#if TIMER_REGISTERS_3 && defined(ICR3) && defined(ICIE3)
+        (TimerNo == 3) ||
+#endif
+#if TIMER_REGISTERS_4 && defined(ICR4) && defined(ICIE4) && !TIMER_INTERRUPT_USING_ATMEGA_32U4
+        // The 10-bit Timer4 of ATmega32U4 has no Input Capture unit
+        (TimerNo == 4) ||
+#endif
+#if TIMER_REGISTERS_5 && defined(ICR5) && defined(ICIE5)
+        (TimerNo == 5) ||
+#endif
+        false;
+    }
+
+    static_assert(isAvailable(), "TimerCapture TimerNo has no Input Capture unit on this board. Only 16-bit timers have one");
+
+  public:
+
+    // Start the timer in normal mode, counting up to 0xFFFF, and capture on edge, CAPTURE_RISING or CAPTURE_FALLING.
+    // noiseCanceler needs 4 equal samples of the ICPn pin, delaying the capture by 4 CPU cycles.
+    // prescalerIndex is NO_PRESCALER .. PRESCALER_1024. The timer can't be used by TimerInterrupt nor StaticTimer
+    static bool begin(uint8_t edge, bool noiseCanceler = false, uint8_t prescalerIndex = NO_PRESCALER,
+                      timer_capture_callback callback = NULL)
+    {
+      if ( (prescalerIndex < NO_PRESCALER) || (prescalerIndex > PRESCALER_1024) )
+        return false;
+
+      uint8_t sregSaved = SREG;
+      noInterrupts();
+
+      _overflows      = 0;
+      _idleOverflows  = 0;
+      _lastCapture    = 0;
+      _period         = 0;
+      _numEdges       = 0;
+      _isNewPeriod    = false;
+      _prescalerIndex = prescalerIndex;
+      _callback       = callback;
+
+      // Stop the clock, clear any stale flag (by writing 1), then start with the prescaler
+      TimerRegisters<TimerNo>::startCapture(prescalerIndex, edge == CAPTURE_RISING, noiseCanceler);
+
+      SREG = sregSaved;
+
+      return true;
+    }
+
+    // Disable the capture and overflow interrupts, the timer keeps counting
+    static void end()
+    {
+      TimerRegisters<TimerNo>::stopCapture();
+    }
+
+    // Period between the last 2 edges, in timer ticks (F_CPU / prescaler). 0 if not yet measured or idle too long
+    static uint32_t getPeriodTicks()
+    {
+      uint8_t sregSaved = SREG;
+      noInterrupts();
+
+      uint32_t period = _period;
+      _isNewPeriod    = false;
+
+      SREG = sregSaved;
+
+      return period;
+    }
+
+    // Period between the last 2 edges, in us. 0 if not yet measured
+    static uint32_t getPeriodMicros()
+    {
+      return (uint32_t) ( (uint64_t) getPeriodTicks() * prescalerDiv[_prescalerIndex] * 1000000ULL / F_CPU );
+    }
+
+    // Frequency of the edges, in Hz. 0 if not yet measured
+    static float getFrequency()
+    {
+      uint32_t period = getPeriodTicks();
+
+      return (period == 0) ? 0 : (float) F_CPU / prescalerDiv[_prescalerIndex] / period;
+    }
+
+    // true if a new period was measured since the last getPeriodTicks(), getPeriodMicros() or getFrequency()
+    static bool available()
+    {
+      return _isNewPeriod;
+    }
+
+    ///////////////////////////////////////////
+
+    // Called by TIMERn_CAPT_vect
+    static void captureISR() __attribute__((always_inline))
+    {
+      uint16_t count      = TimerRegisters<TimerNo>::getCapture();
+      uint16_t overflows  = _overflows;
+
+      // Captured after an overflow not counted yet, not just before it
+      if ( TimerRegisters<TimerNo>::isOverflowPending() && (count < 0x8000) )
+        overflows++;
+
+      uint32_t capture = ((uint32_t) overflows << 16) | count;
+
+      _idleOverflows = 0;
+
+      if (_numEdges < 2)
+        _numEdges++;
+
+      if (_numEdges >= 2)
+      {
+        _period       = capture - _lastCapture;
+        _isNewPeriod  = true;
+      }
+
+      _lastCapture = capture;
+
+      if ( (_numEdges >= 2) && (_callback != NULL) )
+        (*_callback)(_period);
+    }
+
+    // Called by TIMERn_OVF_vect
+    static void overflowISR() __attribute__((always_inline))
+    {
+      _overflows++;
+
+      // No edge for 2^32 ticks => the next period can't be measured, restart
+      if (++_idleOverflows == 0xFFFF)
+      {
+        _numEdges = 0;
+        _period   = 0;
+      }
+    }
+};
+
+template<uint8_t TimerNo> volatile uint16_t TimerCapture<TimerNo>::_overflows     = 0;
+template<uint8_t TimerNo> volatile uint16_t TimerCapture<TimerNo>::_idleOverflows = 0;
+template<uint8_t TimerNo> volatile uint32_t TimerCapture<TimerNo>::_lastCapture   = 0;
+template<uint8_t TimerNo> volatile uint32_t TimerCapture<TimerNo>::_period        = 0;
+template<uint8_t TimerNo> volatile uint8_t  TimerCapture<TimerNo>::_numEdges      = 0;
+template<uint8_t TimerNo> volatile bool     TimerCapture<TimerNo>::_isNewPeriod   = false;
+template<uint8_t TimerNo> uint8_t           TimerCapture<TimerNo>::_prescalerIndex  = NO_PRESCALER;
+template<uint8_t TimerNo> timer_capture_callback TimerCapture<TimerNo>::_callback = NULL;
+
+#endif    // #ifndef TIMER_CAPTURE_HPP
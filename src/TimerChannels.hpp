@@ -0,0 +1,251 @@
+/****************************************************************************************************************************
+  TimerChannels.hpp
+  For Arduino boards (UNO, Nano, Mega, etc. )
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt
+  Licensed under MIT license
+
+  TimerChannels<TimerNo> lets one free-running 16-bit timer host up to 3 independent periodic or one-shot events, one
+  per Output Compare unit, OCRnA, OCRnB and OCRnC (A and B only on ATmega328P Timer1). Each compare value is advanced
+  from the previous one, not from TCNTn, so the periods don't drift with the ISR latency.
+  Periods longer than the 16-bit counter are split into several compares of equal length.
+  Version: 1.8.0
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K Hoang      23/11/2019 Initial coding
+  1.0.1   K Hoang      25/11/2019 New release fixing compiler error
+  1.0.2   K.Hoang      28/11/2019 Permit up to 16 super-long-time, super-accurate ISR-based timers to avoid being blocked
+  1.0.3   K.Hoang      01/12/2020 Add complex examples ISR_16_Timers_Array_Complex and ISR_16_Timers_Array_Complex
+  1.1.1   K.Hoang      06/12/2020 Add example Change_Interval. Bump up version to sync with other TimerInterrupt Libraries
+  1.1.2   K.Hoang      05/01/2021 Fix warnings. Optimize examples to reduce memory usage
+  1.2.0   K.Hoang      07/01/2021 Add better debug feature. Optimize code and examples to reduce RAM usage
+  1.3.0   K.Hoang      25/02/2021 Add support to AVR ATMEGA_32U4 such as Leonardo, YUN, ESPLORA, etc.
+  1.4.0   K.Hoang      01/04/2021 Add support to Adafruit 32U4 and 328(P) such as FEATHER32U4, FEATHER328P, etc.
+  1.4.1   K.Hoang      02/04/2021 Add support to Sparkfun 32U4, 328(P), 128RFA1 such as AVR_PROMICRO, REDBOT, etc.
+  1.5.0   K.Hoang      08/05/2021 Add Timer 3 and 4 to 32U4. Add Timer auto-selection to examples.
+  1.6.0   K.Hoang      15/11/2021 Fix bug resulting half frequency when using high frequencies.
+  1.7.0   K.Hoang      19/11/2021 Fix bug resulting wrong frequency for some frequencies.
+  1.8.0   K.Hoang      18/01/2022 Fix `multiple-definitions` linker error
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef TIMER_CHANNELS_HPP
+#define TIMER_CHANNELS_HPP
+
+// For the board checks, prescaler indexes, TimerDelegate and TimerRegisters
+#include "TimerInterrupt.hpp"
+
+enum
+{
+  CHANNEL_A = 0,
+  CHANNEL_B,
+  CHANNEL_C
+};
+
+// Such as TimerChannels<1>::attachMicros(CHANNEL_B, 2500, handler), with USE_TIMER_CHANNELS_1 true
+// before #include "TimerChannels.h"
+template<uint8_t TimerNo>
+class TimerChannels
+{
+  private:
+
+    struct Channel
+    {
+      // Changed by the ISR, and polled by isAttached()
+      volatile uint32_t periodTicks;      // 0 => not attached
+      volatile uint32_t remainingTicks;   // ticks left to the event, after the loaded compare
+      uint32_t          chunkTicks;       // ticks of each compare, see planChunks()
+      uint32_t          shortChunksTicks;
+      bool              isOneShot;
+      TimerDelegate     callback;
+    };
+
+    static Channel  _channels[3];
+    static uint8_t  _prescalerIndex;
+
+    static constexpr bool isAvailable()
+    {
+      return
+#if TIMER_REGISTERS_1 && defined(OCR1B) && defined(TIMSK1) && defined(OCIE1B)
+        (TimerNo == 1) ||
+#endif
+#if TIMER_REGISTERS_3 && defined(OCR3B) && defined(OCIE3B)
+        (TimerNo == 3) ||
+#endif
+#if TIMER_REGISTERS_4 && defined(OCR4B) && defined(OCIE4B) && !TIMER_INTERRUPT_USING_ATMEGA_32U4
+        // The 10-bit Timer4 of ATmega32U4 has its own registers
+        (TimerNo == 4) ||
+#endif
+#if TIMER_REGISTERS_5 && defined(OCR5B) && defined(OCIE5B)
+        (TimerNo == 5) ||
+#endif
+        false;
+    }
+
+    static_assert(isAvailable(), "TimerChannels TimerNo isn't a 16-bit timer of this board");
+
+    // The next compare, chunkTicks + 1 ticks while remainingTicks > shortChunksTicks, then chunkTicks, up to 65536
+    // as the counter wraps around. See planChunks()
+    static void loadNextCompare(uint8_t channel, uint16_t compare) __attribute__((always_inline))
+    {
+      Channel& chan = _channels[channel];
+
+      uint32_t ticks = (chan.remainingTicks > chan.shortChunksTicks) ? chan.chunkTicks + 1 : chan.chunkTicks;
+
+      chan.remainingTicks -= ticks;
+
+      TimerRegisters<TimerNo>::setCompare(channel, compare + (uint16_t) ticks);
+    }
+
+    // Split periodTicks into the fewest compares, all of the same number of ticks, or 1 more, as
+    // TimerInterrupt::planChunks(). So no compare is much shorter than the others, nor than the ISR latency
+    static void planChunks(uint8_t channel)
+    {
+      Channel&  chan      = _channels[channel];
+      uint32_t  numChunks = (chan.periodTicks - 1) / (MAX_COUNT_16BIT + 1UL) + 1;
+
+      chan.chunkTicks       = chan.periodTicks / numChunks;
+
+      // The (periodTicks % numChunks) first chunks have 1 more tick
+      chan.shortChunksTicks = (numChunks - chan.periodTicks % numChunks) * chan.chunkTicks;
+    }
+
+  public:
+
+    // Up to 3 channels, A, B and C, or 2 if OCRnC doesn't exist
+    static constexpr uint8_t numChannels()
+    {
+      return
+#if defined(OCR1C)
+        (TimerNo == 1) ? 3 :
+#endif
+#if defined(OCR3C)
+        (TimerNo == 3) ? 3 :
+#endif
+#if defined(OCR4C) && !TIMER_INTERRUPT_USING_ATMEGA_32U4
+        (TimerNo == 4) ? 3 :
+#endif
+#if defined(OCR5C)
+        (TimerNo == 5) ? 3 :
+#endif
+        2;
+    }
+
+    // Start the timer free-running, in normal mode from 0 to 0xFFFF, with prescalerIndex NO_PRESCALER .. PRESCALER_1024.
+    // One tick is prescalerDiv[prescalerIndex] CPU cycles, 4us with the default PRESCALER_64 at 16MHz.
+    // All the channels are detached. The timer can't be used by TimerInterrupt, StaticTimer nor TimerCapture
+    static bool begin(uint8_t prescalerIndex = PRESCALER_64)
+    {
+      if ( (prescalerIndex < NO_PRESCALER) || (prescalerIndex > PRESCALER_1024) )
+        return false;
+
+      uint8_t sregSaved = SREG;
+      noInterrupts();
+
+      for (uint8_t channel = 0; channel < numChannels(); channel++)
+        detach(channel);
+
+      _prescalerIndex = prescalerIndex;
+
+      TimerRegisters<TimerNo>::setNormalMode(prescalerIndex);
+
+      SREG = sregSaved;
+
+      return true;
+    }
+
+    // Call callback every ticks timer ticks, or only once after ticks if isOneShot, from the compare interrupt of
+    // channel. The first event is ticks from now. Returns false if channel doesn't exist, or if ticks is shorter than
+    // TIMER_INTERRUPT_ISR_CYCLES, as the compare would be passed before being loaded
+    static bool attachTicks(uint8_t channel, uint32_t ticks, const TimerDelegate& callback, bool isOneShot = false)
+    {
+      if ( (channel >= numChannels()) || !callback.isBound() ||
+           ((uint64_t) ticks * prescalerDiv[_prescalerIndex] < TIMER_INTERRUPT_ISR_CYCLES) )
+        return false;
+
+      uint8_t sregSaved = SREG;
+      noInterrupts();
+
+      _channels[channel].periodTicks    = ticks;
+      _channels[channel].remainingTicks = ticks;
+      _channels[channel].isOneShot      = isOneShot;
+      _channels[channel].callback       = callback;
+
+      planChunks(channel);
+      loadNextCompare(channel, TimerRegisters<TimerNo>::getCount());
+      TimerRegisters<TimerNo>::enableCompareInterrupt(channel, true);
+
+      SREG = sregSaved;
+
+      return true;
+    }
+
+    // Same as attachTicks(), with the period in us, rounded to the tick
+    static bool attachMicros(uint8_t channel, uint32_t micros, const TimerDelegate& callback, bool isOneShot = false)
+    {
+      uint64_t ticks = ((uint64_t) micros * (F_CPU / 1000000UL) + prescalerDiv[_prescalerIndex] / 2) / prescalerDiv[_prescalerIndex];
+
+      if (ticks > 0xFFFFFFFFULL)
+        return false;
+
+      return attachTicks(channel, ticks, callback, isOneShot);
+    }
+
+    // Disable the compare interrupt of channel. The other channels keep running
+    static void detach(uint8_t channel)
+    {
+      if (channel >= numChannels())
+        return;
+
+      // Read-modify-write of TIMSKn, shared with the other channels
+      uint8_t sregSaved = SREG;
+      noInterrupts();
+
+      TimerRegisters<TimerNo>::enableCompareInterrupt(channel, false);
+
+      _channels[channel].periodTicks = 0;
+
+      SREG = sregSaved;
+    }
+
+    // true if channel has a periodic event, or a one-shot not fired yet
+    static bool isAttached(uint8_t channel)
+    {
+      return (channel < numChannels()) && (_channels[channel].periodTicks != 0);
+    }
+
+    ///////////////////////////////////////////
+
+    // Called by TIMERn_COMPx_vect
+    template<uint8_t ChannelNo>
+    __attribute__((always_inline)) static void compareISR()
+    {
+      Channel& channel = _channels[ChannelNo];
+
+      // Intermediate compare of a long period
+      if (channel.remainingTicks != 0)
+      {
+        loadNextCompare(ChannelNo, TimerRegisters<TimerNo>::getCompare(ChannelNo));
+        return;
+      }
+
+      // Next period from this compare, not from now, so without drift
+      if (channel.isOneShot)
+        detach(ChannelNo);
+      else
+      {
+        channel.remainingTicks = channel.periodTicks;
+        loadNextCompare(ChannelNo, TimerRegisters<TimerNo>::getCompare(ChannelNo));
+      }
+
+      channel.callback();
+    }
+};
+
+template<uint8_t TimerNo> typename TimerChannels<TimerNo>::Channel TimerChannels<TimerNo>::_channels[3];
+template<uint8_t TimerNo> uint8_t TimerChannels<TimerNo>::_prescalerIndex = PRESCALER_64;
+
+#endif    // #ifndef TIMER_CHANNELS_HPP
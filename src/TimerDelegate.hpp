@@ -0,0 +1,225 @@
+/****************************************************************************************************************************
+  TimerDelegate.hpp
+  For Arduino boards (UNO, Nano, Mega, etc. )
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt
+  Licensed under MIT license
+
+  TimerDelegate is the callback of TimerInterrupt and ISR_Timer. It binds a free function, a free function and a context
+  of up to TIMER_DELEGATE_CONTEXT_SIZE bytes, or a member function and its object, all stored inline without any heap.
+  Calling it is a single indirect call, and an unbound TimerDelegate calls a no-op function, so no NULL check is needed.
+
+  Version: 1.8.0
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K Hoang      23/11/2019 Initial coding
+  1.0.1   K Hoang      25/11/2019 New release fixing compiler error
+  1.0.2   K.Hoang      28/11/2019 Permit up to 16 super-long-time, super-accurate ISR-based timers to avoid being blocked
+  1.0.3   K.Hoang      01/12/2020 Add complex examples ISR_16_Timers_Array_Complex and ISR_16_Timers_Array_Complex
+  1.1.1   K.Hoang      06/12/2020 Add example Change_Interval. Bump up version to sync with other TimerInterrupt Libraries
+  1.1.2   K.Hoang      05/01/2021 Fix warnings. Optimize examples to reduce memory usage
+  1.2.0   K.Hoang      07/01/2021 Add better debug feature. Optimize code and examples to reduce RAM usage
+  1.3.0   K.Hoang      25/02/2021 Add support to AVR ATMEGA_32U4 such as Leonardo, YUN, ESPLORA, etc.
+  1.4.0   K.Hoang      01/04/2021 Add support to Adafruit 32U4 and 328(P) such as FEATHER32U4, FEATHER328P, etc.
+  1.4.1   K.Hoang      02/04/2021 Add support to Sparkfun 32U4, 328(P), 128RFA1 such as AVR_PROMICRO, REDBOT, etc.
+  1.5.0   K.Hoang      08/05/2021 Add Timer 3 and 4 to 32U4. Add Timer auto-selection to examples.
+  1.6.0   K.Hoang      15/11/2021 Fix bug resulting half frequency when using high frequencies.
+  1.7.0   K.Hoang      19/11/2021 Fix bug resulting wrong frequency for some frequencies.
+  1.8.0   K.Hoang      18/01/2022 Fix `multiple-definitions` linker error
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef TIMER_DELEGATE_HPP
+#define TIMER_DELEGATE_HPP
+
+#include <stdint.h>
+#include <string.h>
+
+typedef void (*timer_callback)(void);
+typedef void (*timer_callback_p)(void *);
+
+// Callback with a parameter and the number of runs missed since the previous call, see ISR_TimerN::setCatchUp()
+typedef void (*timer_callback_missed)(void *, unsigned long missedRuns);
+
+// Max size of the context bound to a free function, such as the argument of TimerInterrupt::attachInterrupt().
+// Each TimerDelegate takes TIMER_DELEGATE_CONTEXT_SIZE + 4 bytes of RAM on AVR. 6 is also the size of a member
+// function binding on AVR
+#ifndef TIMER_DELEGATE_CONTEXT_SIZE
+  #define TIMER_DELEGATE_CONTEXT_SIZE     6
+#endif
+
+class TimerDelegate
+{
+  public:
+
+    // unbound, calls nothing
+    TimerDelegate() : _invoker(invokeNone)
+    {
+    }
+
+    TimerDelegate(timer_callback f)
+    {
+      bindFunction(f);
+    }
+
+    TimerDelegate(timer_callback_p f, void* p)
+    {
+      bindContext(f, p);
+    }
+
+    // f is also called with the number of missed runs, given by ISR_Timer
+    TimerDelegate(timer_callback_missed f, void* p)
+    {
+      if (f == NULL)
+      {
+        _invoker = invokeNone;
+        return;
+      }
+
+      FunctionContext<void*, timer_callback_missed> bound = { f, p };
+
+      memcpy(&_storage, &bound, sizeof(bound));
+      _invoker = invokeMissed;
+    }
+
+    // f is called with a copy of context. TArg is copied bytewise, so it must be a plain type or struct
+    template<typename TArg>
+    TimerDelegate(void (*f)(TArg), TArg context)
+    {
+      bindContext(f, context);
+    }
+
+    // object->method() is called
+    template<class T>
+    TimerDelegate(T* object, void (T::*method)())
+    {
+      static_assert(sizeof(MemberFunction<T>) <= sizeof(Storage), "TimerDelegate member function doesn't fit");
+
+      if ( (object == NULL) || (method == NULL) )
+      {
+        _invoker = invokeNone;
+        return;
+      }
+
+      MemberFunction<T> bound = { object, method };
+
+      memcpy(&_storage, &bound, sizeof(bound));
+      _invoker = invokeMember<T>;
+    }
+
+    // missedRuns is only used by timer_callback_missed functions
+    void operator()(unsigned long missedRuns = 0) const __attribute__((always_inline))
+    {
+      (*_invoker)(&_storage, missedRuns);
+    }
+
+    bool isBound() const
+    {
+      return (_invoker != invokeNone);
+    }
+
+  private:
+
+    typedef void (*invoker_t)(const void* storage, unsigned long missedRuns);
+
+    template<typename TArg, typename TFunction = void (*)(TArg)>
+    struct FunctionContext
+    {
+      TFunction function;
+      TArg      context;
+    };
+
+    template<class T>
+    struct MemberFunction
+    {
+      T*      object;
+      void    (T::*method)();
+    };
+
+    class Undefined;
+
+    // large enough for all the bindings
+    union Storage
+    {
+      FunctionContext<uint8_t[TIMER_DELEGATE_CONTEXT_SIZE]> function;
+      MemberFunction<Undefined>                             member;
+    };
+
+    Storage   _storage;
+    invoker_t _invoker;
+
+    void bindFunction(timer_callback f)
+    {
+      if (f == NULL)
+      {
+        _invoker = invokeNone;
+        return;
+      }
+
+      memcpy(&_storage, &f, sizeof(f));
+      _invoker = invokeFunction;
+    }
+
+    template<typename TArg>
+    void bindContext(void (*f)(TArg), TArg context)
+    {
+      static_assert(sizeof(FunctionContext<TArg>) <= sizeof(Storage),
+                    "TimerDelegate context must be <= TIMER_DELEGATE_CONTEXT_SIZE bytes");
+
+      if (f == NULL)
+      {
+        _invoker = invokeNone;
+        return;
+      }
+
+      FunctionContext<TArg> bound = { f, context };
+
+      memcpy(&_storage, &bound, sizeof(bound));
+      _invoker = invokeContext<TArg>;
+    }
+
+    static void invokeNone(const void* storage, unsigned long missedRuns)
+    {
+      (void) storage;
+      (void) missedRuns;
+    }
+
+    static void invokeFunction(const void* storage, unsigned long missedRuns)
+    {
+      (void) missedRuns;
+
+      (*(*(const timer_callback*) storage))();
+    }
+
+    template<typename TArg>
+    static void invokeContext(const void* storage, unsigned long missedRuns)
+    {
+      (void) missedRuns;
+
+      const FunctionContext<TArg>* bound = (const FunctionContext<TArg>*) storage;
+
+      (*bound->function)(bound->context);
+    }
+
+    static void invokeMissed(const void* storage, unsigned long missedRuns)
+    {
+      const FunctionContext<void*, timer_callback_missed>* bound = (const FunctionContext<void*, timer_callback_missed>*) storage;
+
+      (*bound->function)(bound->context, missedRuns);
+    }
+
+    template<class T>
+    static void invokeMember(const void* storage, unsigned long missedRuns)
+    {
+      (void) missedRuns;
+
+      const MemberFunction<T>* bound = (const MemberFunction<T>*) storage;
+
+      (bound->object->*bound->method)();
+    }
+};
+
+#endif    // #ifndef TIMER_DELEGATE_HPP
@@ -0,0 +1,135 @@
+/****************************************************************************************************************************
+  TimerGroup.hpp
+  For Arduino boards (UNO, Nano, Mega, etc. )
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt
+  Licensed under MIT license
+
+  TimerGroup starts several TimerInterrupt timers together, holding their shared prescaler in reset with the TSM bit
+  of GTCCR while their counters are preset, so that their interrupts keep a fixed phase to each other, such as for
+  interleaved multi-phase PWM or sampling. Each timer may lag by a phase, in us, within its period.
+  Version: 1.8.0
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K Hoang      23/11/2019 Initial coding
+  1.0.1   K Hoang      25/11/2019 New release fixing compiler error
+  1.0.2   K.Hoang      28/11/2019 Permit up to 16 super-long-time, super-accurate ISR-based timers to avoid being blocked
+  1.0.3   K.Hoang      01/12/2020 Add complex examples ISR_16_Timers_Array_Complex and ISR_16_Timers_Array_Complex
+  1.1.1   K.Hoang      06/12/2020 Add example Change_Interval. Bump up version to sync with other TimerInterrupt Libraries
+  1.1.2   K.Hoang      05/01/2021 Fix warnings. Optimize examples to reduce memory usage
+  1.2.0   K.Hoang      07/01/2021 Add better debug feature. Optimize code and examples to reduce RAM usage
+  1.3.0   K.Hoang      25/02/2021 Add support to AVR ATMEGA_32U4 such as Leonardo, YUN, ESPLORA, etc.
+  1.4.0   K.Hoang      01/04/2021 Add support to Adafruit 32U4 and 328(P) such as FEATHER32U4, FEATHER328P, etc.
+  1.4.1   K.Hoang      02/04/2021 Add support to Sparkfun 32U4, 328(P), 128RFA1 such as AVR_PROMICRO, REDBOT, etc.
+  1.5.0   K.Hoang      08/05/2021 Add Timer 3 and 4 to 32U4. Add Timer auto-selection to examples.
+  1.6.0   K.Hoang      15/11/2021 Fix bug resulting half frequency when using high frequencies.
+  1.7.0   K.Hoang      19/11/2021 Fix bug resulting wrong frequency for some frequencies.
+  1.8.0   K.Hoang      18/01/2022 Fix `multiple-definitions` linker error
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef TIMER_GROUP_HPP
+#define TIMER_GROUP_HPP
+
+#include "TimerInterrupt.hpp"
+
+#ifndef TIMER_GROUP_SIZE
+  #define TIMER_GROUP_SIZE      4
+#endif
+
+// Timers already set by attachInterrupt() or setFrequency(), then restarted together by start(), such as
+//   group.add(ITimer1); group.add(ITimer3, 333); group.start();
+// Timers 1, 3, 4 and 5 (and 2 of ATmega328P, with its own prescaler) are held while being preset. Timers without
+// prescaler and Timer4 of ATmega32U4 aren't, and start a few CPU cycles apart.
+// Timer0, for millis() and micros(), shares the prescaler and loses a few us at each start()
+class TimerGroup
+{
+  private:
+
+    TimerInterrupt* _timers[TIMER_GROUP_SIZE];
+    uint32_t        _phaseMicros[TIMER_GROUP_SIZE];
+    uint8_t         _numTimers;
+
+  public:
+
+    TimerGroup()
+    {
+      _numTimers = 0;
+    }
+
+    // Interrupts of timer will come phaseMicros after those of a timer of the same period with no phase, up to 2^32
+    // cycles of the timer clock (268s at 16MHz). Returns false if the group is full or timer is already in it
+    bool add(TimerInterrupt& timer, uint32_t phaseMicros = 0)
+    {
+      if (_numTimers >= TIMER_GROUP_SIZE)
+      {
+        TISR_LOGERROR(("TimerGroup full"));
+
+        return false;
+      }
+
+      for (uint8_t i = 0; i < _numTimers; i++)
+      {
+        if (_timers[i] == &timer)
+          return false;
+      }
+
+      _timers[_numTimers]       = &timer;
+      _phaseMicros[_numTimers]  = phaseMicros;
+      _numTimers++;
+
+      return true;
+    }
+
+    uint8_t getNumTimers() __attribute__((always_inline))
+    {
+      return _numTimers;
+    }
+
+    // Restart the periods of all timers of the group from their phase, at the same timer clock.
+    // A period restarted with TIMER_INTERRUPT_TIME_BASE true isn't counted in getMicros()
+    void start()
+    {
+      uint8_t sregSaved = SREG;
+      noInterrupts();
+
+#if defined(GTCCR) && defined(TSM)
+      // Hold the prescalers in reset until all counters are preset
+  #if defined(PSRASY)
+      GTCCR = _BV(TSM) | _BV(PSRSYNC) | _BV(PSRASY);
+  #else
+      GTCCR = _BV(TSM) | _BV(PSRSYNC);
+  #endif
+#endif
+
+      for (uint8_t i = 0; i < _numTimers; i++)
+        _timers[i]->pauseTimer();
+
+      for (uint8_t i = 0; i < _numTimers; i++)
+      {
+        TimerInterrupt* timer = _timers[i];
+
+        // Cycles of the timer clock, then counts after the prescaler, rounded. Integer math only
+        uint32_t remainder;
+        uint32_t cycles = TimerInterrupt::mulDiv(_phaseMicros[i], timer->getTimerClock(), 1000000UL, remainder);
+        uint16_t div    = timer->getPrescalerDiv();
+
+        timer->restartPeriod( (div == 1) ? cycles + (remainder >= 500000UL) : cycles / div + (cycles % div >= div / 2) );
+      }
+
+      for (uint8_t i = 0; i < _numTimers; i++)
+        _timers[i]->resumeTimer();
+
+#if defined(GTCCR) && defined(TSM)
+      // Release the prescalers, all from 0
+      GTCCR = 0;
+#endif
+
+      SREG = sregSaved;
+    }
+};
+
+#endif    // TIMER_GROUP_HPP
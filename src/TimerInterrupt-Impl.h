@@ -110,341 +110,1271 @@ void TimerInterrupt::init(int8_t timer)
 #if defined(TCCR4A) && defined(TCCR4B) &&  defined(TIMSK4)
 
     case 4:
+#if TIMER_INTERRUPT_USING_ATMEGA_32U4
+      // 10 bit timer. Page 166-169 of ATmega16U4/32U4, normal mode (WGM41:40 = 0) => count from 0 to TOP = OCR4C,
+      // so OCR4C sets the period, like OCRnA in CTC mode. Clocked by the CPU clock, see setTimer4Clock()
+      TCCR4A = 0;
+      TCCR4B = 0;
+      TCCR4C = 0;
+      TCCR4D = 0;
+      TCCR4E = 0;
+  #if defined(PLLFRQ) && defined(PLLTM0)
+      PLLFRQ &= ~(_BV(PLLTM1) | _BV(PLLTM0));
+  #endif
+      _timerClock = F_CPU;
+#else
       // 16 bit timer
       TCCR4A = 0;
       TCCR4B = 0;
-#if defined(WGM42)
       bitWrite(TCCR4B, WGM42, 1);
-#elif defined(CS43)
-      // TODO this may not be correct
-      // atmega32u4
-      bitWrite(TCCR4B, CS43, 1);
 #endif
       bitWrite(TCCR4B, CS40, 1);
 
-      TISR_LOGWARN(F("T4"));
+      TISR_LOGWARN(F("T4"));
+
+      break;
+#endif
+
+#if defined(TCCR5A) && defined(TCCR5B) &&  defined(TIMSK5)
+
+    case 5:
+      // 16 bit timer
+      TCCR5A = 0;
+      TCCR5B = 0;
+      bitWrite(TCCR5B, WGM52, 1);
+      bitWrite(TCCR5B, CS50, 1);
+
+      TISR_LOGWARN(F("T5"));
+
+      break;
+#endif
+  }
+
+  _timer = timer;
+
+  //sei();//enable interrupts
+  interrupts();
+
+}
+
+void TimerInterrupt::set_OCR()
+{
+  // Run with noInterrupt()
+  // Set the OCR for the given timer,
+  // set the toggle count,
+  // then turn on the interrupts
+  switch (_timer)
+  {
+#if TIMER_REGISTERS_1
+
+    case 1:
+      set_OCR<1>();
+      break;
+#endif
+
+#if TIMER_REGISTERS_2
+
+    case 2:
+      set_OCR<2>();
+      break;
+#endif
+
+#if TIMER_REGISTERS_3
+
+    case 3:
+      set_OCR<3>();
+      break;
+#endif
+
+#if TIMER_REGISTERS_4
+
+    case 4:
+      set_OCR<4>();
+      break;
+#endif
+
+#if TIMER_REGISTERS_5
+
+    case 5:
+      set_OCR<5>();
+      break;
+#endif
+  }
+}
+
+void TimerInterrupt::adjust_OCRValue()
+{
+  switch (_timer)
+  {
+#if TIMER_REGISTERS_1
+
+    case 1:
+      adjust_OCRValue<1>();
+      break;
+#endif
+
+#if TIMER_REGISTERS_2
+
+    case 2:
+      adjust_OCRValue<2>();
+      break;
+#endif
+
+#if TIMER_REGISTERS_3
+
+    case 3:
+      adjust_OCRValue<3>();
+      break;
+#endif
+
+#if TIMER_REGISTERS_4
+
+    case 4:
+      adjust_OCRValue<4>();
+      break;
+#endif
+
+#if TIMER_REGISTERS_5
+
+    case 5:
+      adjust_OCRValue<5>();
+      break;
+#endif
+  }
+}
+
+void TimerInterrupt::reload_OCRValue()
+{
+  switch (_timer)
+  {
+#if TIMER_REGISTERS_1
+
+    case 1:
+      reload_OCRValue<1>();
+      break;
+#endif
+
+#if TIMER_REGISTERS_2
+
+    case 2:
+      reload_OCRValue<2>();
+      break;
+#endif
+
+#if TIMER_REGISTERS_3
+
+    case 3:
+      reload_OCRValue<3>();
+      break;
+#endif
+
+#if TIMER_REGISTERS_4
+
+    case 4:
+      reload_OCRValue<4>();
+      break;
+#endif
+
+#if TIMER_REGISTERS_5
+
+    case 5:
+      reload_OCRValue<5>();
+      break;
+#endif
+  }
+}
+
+void TimerInterrupt::setPrescaler(uint8_t prescalerIndex)
+{
+  switch (_timer)
+  {
+#if TIMER_REGISTERS_1
+
+    case 1:
+      TimerRegisters<1>::setPrescaler(prescalerIndex);
+      break;
+#endif
+
+#if TIMER_REGISTERS_2
+
+    case 2:
+      TimerRegisters<2>::setPrescaler(prescalerIndex);
+      break;
+#endif
+
+#if TIMER_REGISTERS_3
+
+    case 3:
+      TimerRegisters<3>::setPrescaler(prescalerIndex);
+      break;
+#endif
+
+#if TIMER_REGISTERS_4
+
+    case 4:
+      TimerRegisters<4>::setPrescaler(prescalerIndex);
+      break;
+#endif
+
+#if TIMER_REGISTERS_5
+
+    case 5:
+      TimerRegisters<5>::setPrescaler(prescalerIndex);
+      break;
+#endif
+  }
+
+  TISR_LOGWARN3(F("Timer ="), _timer, F(", prescalerIndex ="), prescalerIndex);
+}
+
+// Shift-and-add long division, on the bits of b: (quotient, remainder) of a * b / c is doubled for each bit, and
+// a / c added for the bits set. The remainders are kept below c without ever exceeding 32 bits
+uint32_t TimerInterrupt::mulDiv(uint32_t a, uint32_t b, uint32_t c, uint32_t& remainder)
+{
+  uint32_t  aQuotient   = a / c;
+  uint32_t  aRemainder  = a % c;
+  uint32_t  quotient    = 0;
+
+  remainder = 0;
+
+  for (uint32_t bit = 0x80000000UL; bit != 0; bit >>= 1)
+  {
+    // the quotient is doubled: overflow
+    if (quotient & 0x80000000UL)
+    {
+      remainder = 0;
+
+      return 0xFFFFFFFFUL;
+    }
+
+    quotient <<= 1;
+
+    if (remainder >= c - remainder)
+    {
+      remainder -= c - remainder;
+      quotient++;
+    }
+    else
+    {
+      remainder <<= 1;
+    }
+
+    if (b & bit)
+    {
+      // overflow, or only 0xFFFFFFFF left
+      if (quotient >= 0xFFFFFFFFUL - aQuotient)
+      {
+        remainder = 0;
+
+        return 0xFFFFFFFFUL;
+      }
+
+      quotient += aQuotient;
+
+      if (remainder >= c - aRemainder)
+      {
+        remainder -= c - aRemainder;
+        quotient++;
+      }
+      else
+      {
+        remainder += aRemainder;
+      }
+    }
+  }
+
+  return quotient;
+}
+
+uint32_t TimerInterrupt::fraction32(uint32_t remainder, uint32_t c)
+{
+  uint32_t fraction = 0;
+
+  for (uint8_t i = 0; i < 32; i++)
+  {
+    fraction <<= 1;
+
+    if (remainder >= c - remainder)
+    {
+      remainder -= c - remainder;
+      fraction |= 1;
+    }
+    else
+    {
+      remainder <<= 1;
+    }
+  }
+
+  return fraction;
+}
+
+// The prescaler divisions are powers of 2: timer clock * den / (num * 2^k) is the quotient of timer clock / 2^s * den
+// by num, divided again by 2^(k - s), with 2^s the part of 2^k dividing the timer clock. Exact, with mulDiv()
+uint32_t TimerInterrupt::periodCounts(uint32_t num, uint32_t den, uint8_t prescalerIndex, uint32_t& fraction)
+{
+  uint32_t  clock       = getTimerClock();
+  uint16_t  div         = getPrescalerDiv(prescalerIndex);
+  uint8_t   countShift  = 0;
+  uint32_t  remainder;
+
+  for ( ; div > 1; div >>= 1)
+  {
+    if ( (clock & 1) == 0 )
+      clock >>= 1;
+    else
+      countShift++;
+  }
+
+  uint32_t counts = mulDiv(clock, den, num, remainder);
+
+  if (counts == 0xFFFFFFFFUL)
+  {
+    fraction = 0;
+
+    return counts;
+  }
+
+  fraction = fraction32(remainder, num);
+
+  if (countShift > 0)
+  {
+    // the counts shifted out are the top of the fraction
+    fraction  = (counts << (32 - countShift)) | (fraction >> countShift);
+    counts  >>= countShift;
+  }
+
+  return counts;
+}
+
+// Periods of num / den Hz in duration ms, i.e. num * duration / (den * 1000)
+uint32_t TimerInterrupt::countPeriods(uint32_t num, uint32_t den, unsigned long duration)
+{
+  if (den <= 0xFFFFFFFFUL / 1000)
+    return mulDiv(num, duration, den * 1000);
+
+  return mulDiv(num, duration, den) / 1000;
+}
+
+// Choose, among all the prescalers, the one giving the period closest to F_CPU * den / num CPU cycles, i.e. to a
+// frequency of num / den Hz. Integer math only, see periodCounts(). On a tie, the larger prescaler wins, with fewer chained compares.
+// With PLAN_FEWEST_WAKEUPS, the largest prescaler within _maxErrorPpm of the period wins, if any.
+// Prescalers needing 16384 chained compares or more are skipped, unless none fits, then the largest one is used.
+// With singleCompare, only the prescalers fitting the period in one compare are used, returns false if none
+bool TimerInterrupt::planFrequency(uint32_t num, uint32_t den, uint8_t& prescalerIndex, uint32_t& OCRValue,
+                                   bool singleCompare)
+{
+  uint32_t      maxCount      = getMaxCount();
+  uint8_t       lastIndex     = getLastPrescalerIndex();
+  // Errors are in 1 / 65536 timer clock cycle
+  uint32_t      bestError     = 0;
+  bool          isFound       = false;
+  bool          isWithinError = false;
+
+  for (uint8_t index = NO_PRESCALER; index <= lastIndex; index++)
+  {
+    uint16_t div      = getPrescalerDiv(index);
+    uint32_t fraction;
+    uint32_t counts   = periodCounts(num, den, index, fraction);
+
+    // Error of the rounded period, in 1 / 2^32 count
+    if ( (fraction >= 0x80000000UL) && (counts < 0xFFFFFFFFUL) )
+    {
+      counts++;
+      fraction = -fraction;
+    }
+
+    if ( (counts > 16384UL * (maxCount + 1)) && (isFound || (index != lastIndex)) )
+      continue;
+
+    if ( singleCompare && (counts > maxCount + 1) )
+      continue;
+
+    if (counts == 0)
+    {
+      counts    = 1;
+      fraction  = -fraction;
+    }
+
+    // A period of OCR lasts exactly OCR + 1 counts, chained or not, see planChunks()
+    uint32_t error = (fraction >> 16) * div;
+
+    TISR_LOGWARN3(F("OCR ="), counts - 1, F(", preScalerDiv ="), div);
+
+    if (_planPolicy == PLAN_FEWEST_WAKEUPS)
+    {
+      // _maxErrorPpm of the period, in 1 / 65536 count as (fraction >> 16): 65536 / 10^6 = 4096 / 62500
+      uint32_t maxError = mulDiv(counts, (uint32_t) _maxErrorPpm << 12, 62500);
+
+      // Larger prescaler => fewer or as many compares per period. Once one is within the error, only those can win
+      if ( (fraction >> 16) <= maxError )
+        isWithinError = true;
+      else if (isWithinError)
+        continue;
+    }
+
+    if (!isFound || (error <= bestError) || isWithinError)
+    {
+      bestError       = error;
+      prescalerIndex  = index;
+      OCRValue        = counts - 1;
+      isFound         = true;
+    }
+  }
+
+  return isFound;
+}
+
+// Split the period of _OCRValue + 1 counts into the fewest compares, all of the same number of counts, or 1 more,
+// so that the intermediate interrupts are evenly spread, and restart the period
+void TimerInterrupt::planChunks()
+{
+  uint32_t  maxCount  = getMaxCount();
+  uint32_t  counts    = _OCRValue + 1;
+
+  _numChunks          = (counts + maxCount) / (maxCount + 1);
+  _chunkCounts        = counts / _numChunks;
+
+  // The (counts % _numChunks) first chunks have 1 more count
+  _shortChunksCounts  = (_numChunks - counts % _numChunks) * _chunkCounts;
+
+  _OCRValueRemaining  = counts;
+}
+
+// With setDithering(true), replace the rounded period by its whole counts, OCR, and the fraction left, added each
+// period by dither_OCRValue(). Uses the smallest prescaler fitting one compare, with OCR + 1 still in range, and
+// within _maxJitterCycles. Otherwise, or if the period is already whole, the rounded period of planFrequency() stays
+void TimerInterrupt::planDithering(uint32_t num, uint32_t den)
+{
+  uint32_t      maxCount      = getMaxCount();
+  uint8_t       lastIndex     = getLastPrescalerIndex();
+
+  _ditherStep   = 0;
+  _ditherPhase  = 0;
+
+  if (!_isDitheringAllowed)
+    return;
+
+  for (uint8_t index = NO_PRESCALER; index <= lastIndex; index++)
+  {
+    uint16_t div      = getPrescalerDiv(index);
+    uint32_t fraction;
+
+    if (div > _maxJitterCycles)
+      break;
+
+    uint32_t counts   = periodCounts(num, den, index, fraction);
+
+    if ( (counts == 0) || (counts > maxCount) )
+      continue;
+
+    if (fraction == 0)
+      return;
+
+    _ditherStep     = fraction;
+    _prescalerIndex = index;
+    _OCRValue       = counts - 1;
+
+    TISR_LOGWARN3(F("Dithering: OCR ="), _OCRValue, F(", step ="), _ditherStep);
+
+    return;
+  }
+}
+
+// frequency of num / den hertz, and duration (in milliseconds).
+// Return true if frequency is OK with selected timer (OCRValue is in range)
+bool TimerInterrupt::setFrequency(uint32_t num, uint32_t den, const TimerDelegate& callback, unsigned long duration)
+{
+  uint8_t       prescalerIndex;
+  uint32_t      OCRValue;
+
+  // Limit frequency to larger than (0.00372529 / 64) Hz or interval 17179.840s / 17179840 ms to avoid uint32_t overflow
+  if ( (_timer <= 0) || !callback.isBound() || (num == 0) || (den == 0) ||
+       (mulDiv(den, 1000, num) >= 17179840UL) )
+  {
+    return false;
+  }
+  else
+  {
+    // Calculate the toggle count. Duration must be at least longer then one cycle
+    if (duration > 0)
+    {
+      _toggle_count = countPeriods(num, den, duration);
+
+      TISR_LOGWARN1(F("setFrequency => _toggle_count ="), _toggle_count);
+      TISR_LOGWARN3(F("Frequency * den ="), num, F(", duration ="), duration);
+
+      if (_toggle_count < 1)
+      {
+        return false;
+      }
+    }
+    else
+    {
+      _toggle_count = -1;
+    }
+
+    planFrequency(num, den, prescalerIndex, OCRValue);
+
+    // We use very large _OCRValue now, split into equal compares, so that we can create very long timer,
+    // even if the counter is only 8 or 16-bit.
+    _OCRValue           = OCRValue;
+    _prescalerIndex     = prescalerIndex;
+
+    planDithering(num, den);
+    planChunks();
+
+    TISR_LOGWARN3(F("_OCR ="), _OCRValue, F(", _preScalerIndex ="), _prescalerIndex);
+
+    //cli();//stop interrupts
+    noInterrupts();
+
+    _frequencyNum = num;
+    _frequencyDen = den;
+    _callback     = callback;
+
+    _timerDone        = false;
+    _isPeriodPending  = false;
+
+    setPrescaler(_prescalerIndex);
+
+    // Set the OCR for the given timer,
+    // set the toggle count,
+    // then turn on the interrupts
+    set_OCR();
+
+    //sei();//allow interrupts
+    interrupts();
+
+    return true;
+  }
+}
+
+// Square wave of num / den hertz on pin, with Compare Output Mode toggle in CTC mode. Without any interrupt
+bool TimerInterrupt::attachOutput(uint32_t num, uint32_t den, uint8_t pin)
+{
+  uint8_t   pinTimer  = digitalPinToTimer(pin);
+  bool      isOutput  = false;
+  uint8_t   prescalerIndex;
+  uint32_t  OCRValue;
+
+  if ( (_timer <= 0) || (num == 0) || (den == 0) )
+    return false;
+
+  // One toggle per compare => compares at twice the output frequency
+  if (num <= 0x7FFFFFFFUL)
+    num *= 2;
+  else if ((den % 2) == 0)
+    den /= 2;
+  else
+    return false;
+
+  // The hardware can't chain compares
+  if (!planFrequency(num, den, prescalerIndex, OCRValue, true))
+  {
+    TISR_LOGWARN1(F("attachOutput: frequency out of range of T"), _timer);
+
+    return false;
+  }
+
+  uint8_t sregSaved = SREG;
+  noInterrupts();
+
+  switch (_timer)
+  {
+#if TIMER_REGISTERS_1
+
+    case 1:
+      isOutput = startOutput<1>(pinTimer, prescalerIndex, OCRValue);
+      break;
+#endif
+
+#if TIMER_REGISTERS_2
+
+    case 2:
+      isOutput = startOutput<2>(pinTimer, prescalerIndex, OCRValue);
+      break;
+#endif
+
+#if TIMER_REGISTERS_3
+
+    case 3:
+      isOutput = startOutput<3>(pinTimer, prescalerIndex, OCRValue);
+      break;
+#endif
+
+#if TIMER_REGISTERS_4
+
+    case 4:
+      isOutput = startOutput<4>(pinTimer, prescalerIndex, OCRValue);
+      break;
+#endif
+
+#if TIMER_REGISTERS_5
+
+    case 5:
+      isOutput = startOutput<5>(pinTimer, prescalerIndex, OCRValue);
+      break;
+#endif
+  }
+
+  if (isOutput)
+  {
+    pinMode(pin, OUTPUT);
+
+    _frequencyNum   = num;
+    _frequencyDen   = den;
+    _prescalerIndex = prescalerIndex;
+    _OCRValue       = OCRValue;
+    _ditherStep     = 0;
+    _isPeriodPending  = false;
+
+    planChunks();
+  }
+
+  SREG = sregSaved;
+
+  TISR_LOGWARN3(F("attachOutput: pin ="), pin, F(", OK ="), isOutput);
+
+  return isOutput;
+}
+
+void TimerInterrupt::detachOutput()
+{
+  switch (_timer)
+  {
+#if TIMER_REGISTERS_1
+
+    case 1:
+      TimerRegisters<1>::clearOutputs();
+      break;
+#endif
+
+#if TIMER_REGISTERS_2
+
+    case 2:
+      TimerRegisters<2>::clearOutputs();
+      break;
+#endif
+
+#if TIMER_REGISTERS_3
+
+    case 3:
+      TimerRegisters<3>::clearOutputs();
+      break;
+#endif
+
+#if TIMER_REGISTERS_4
+
+    case 4:
+      TimerRegisters<4>::clearOutputs();
+      break;
+#endif
+
+#if TIMER_REGISTERS_5
+
+    case 5:
+      TimerRegisters<5>::clearOutputs();
+      break;
+#endif
+  }
+}
+
+#if TIMER_INTERRUPT_USING_ATMEGA_32U4
+
+// PLL Postcaler for High Speed Timer, PLLTM1:0 of PLLFRQ, page 41 of ATmega16U4/32U4 [DATASHEET]:
+// 01 => PLL / 1, 10 => PLL / 1.5, 11 => PLL / 2. PDIV3:0 = 0100 => PLL at 48MHz, 1010 => 96MHz
+bool TimerInterrupt::setTimer4Clock(uint8_t clockSource)
+{
+  uint8_t   postscaler;
+  uint32_t  timerClock;
+  bool      isPLL96MHz  = ((PLLFRQ & 0x0F) == (_BV(PDIV3) | _BV(PDIV1)));
+
+  if (_timer != 4)
+    return false;
+
+  switch (clockSource)
+  {
+    case TIMER4_CLOCK_CPU:
+      postscaler  = 0;
+      timerClock  = F_CPU;
+      break;
+
+#if !TIMER_INTERRUPT_TIME_BASE
+
+    case TIMER4_CLOCK_PLL_48MHZ:
+      // Keep the PLL of USB as is
+      postscaler  = isPLL96MHz ? (_BV(PLLTM1) | _BV(PLLTM0)) : _BV(PLLTM0);
+      timerClock  = 48000000UL;
+      break;
+
+    case TIMER4_CLOCK_PLL_64MHZ:
+  #if defined(USBCON) && defined(USBE)
+      // Relocking the PLL would stop the clock of USB, and drop its connection, such as Serial of Leonardo / Micro
+      if ( !isPLL96MHz && bitRead(USBCON, USBE) )
+      {
+        TISR_LOGWARN(F("setTimer4Clock: 64MHz refused, USB is running on the PLL"));
+
+        return false;
+      }
+  #endif
+
+      postscaler  = _BV(PLLTM1);
+      timerClock  = 64000000UL;
+      break;
+#endif
+
+    default:
+      return false;
+  }
+
+  uint8_t sregSaved = SREG;
+  noInterrupts();
+
+  if (postscaler != 0)
+  {
+    if ( (clockSource == TIMER4_CLOCK_PLL_64MHZ) && !isPLL96MHz )
+    {
+      // Relock at 96MHz, divided by 2 for USB with PLLUSB. Only 96MHz / 1.5 gives 64MHz
+      PLLCSR &= ~_BV(PLLE);
+      PLLFRQ = (PLLFRQ & _BV(PINMUX)) | _BV(PLLUSB) | _BV(PDIV3) | _BV(PDIV1);
+    }
+
+    // Off without USB, or relocking. 16MHz crystal => PINDIV
+    if (!bitRead(PLLCSR, PLLE))
+      PLLCSR = ( (F_CPU == 16000000UL) ? _BV(PINDIV) : 0 ) | _BV(PLLE);
+
+    while (!bitRead(PLLCSR, PLOCK));
+  }
+
+  PLLFRQ = (PLLFRQ & ~(_BV(PLLTM1) | _BV(PLLTM0))) | postscaler;
+
+  _timerClock = timerClock;
+
+  SREG = sregSaved;
+
+  TISR_LOGWARN1(F("setTimer4Clock: Hz ="), _timerClock);
+
+  return true;
+}
+
+#endif    // #if TIMER_INTERRUPT_USING_ATMEGA_32U4
+
+// Tickless mode. interval (in ms) is at most 65535ms, longer ones just wake up earlier
+void TimerInterrupt::setNextInterval(unsigned long interval)
+{
+  if (interval == 0)
+  {
+    stopNextInterval();
+    return;
+  }
+
+  setNextCycles(min(interval, 65535UL) * (F_CPU / 1000));
+}
+
+// Tickless mode. interval (in us) is at most 65535000us, longer ones just wake up earlier
+void TimerInterrupt::setNextIntervalMicros(unsigned long interval)
+{
+  if (interval == 0)
+  {
+    stopNextInterval();
+    return;
+  }
+
+  setNextCycles(min(interval, 65535000UL) * clockCyclesPerMicrosecond());
+}
+
+// Tickless mode with nothing to wait for
+void TimerInterrupt::stopNextInterval()
+{
+#if TIMER_INTERRUPT_TIME_BASE
+  // Without interrupts, the wraps of the counter would be lost for getMicros(). Keep the intermediate compares
+  // of the longest possible interval instead, they only count the time and don't call the callback
+  setNextCycles(0xFFFF0000UL);
+#else
+  detachInterrupt();
+#endif
+}
+
+// Restart the count and interrupt once after cycles CPU clock cycles
+void TimerInterrupt::setNextCycles(uint32_t cycles)
+{
+  uint32_t      maxCount      = getMaxCount() + 1;
+  uint8_t       lastIndex     = getLastPrescalerIndex();
+  uint8_t       prescalerIndex;
+  uint32_t      counts;
+
+#if TIMER_INTERRUPT_USING_ATMEGA_32U4
+  // In timer clock cycles, if Timer4 is on the PLL
+  if (_timerClock != F_CPU)
+    cycles = mulDiv(cycles, _timerClock, F_CPU);
+#endif
+
+  // Smallest prescaler => best resolution, as long as the interval fits in one compare.
+  // Otherwise, the largest one with the fewest intermediate interrupts
+  for (prescalerIndex = NO_PRESCALER; ; prescalerIndex++)
+  {
+    uint16_t div = getPrescalerDiv(prescalerIndex);
+
+    counts = (cycles + div / 2) / div;
+
+    if ( (counts <= maxCount) || (prescalerIndex == lastIndex) )
+      break;
+  }
+
+  if (counts == 0)
+    counts = 1;
+
+  // Also valid when called from an ISR, unlike noInterrupts() / interrupts()
+  uint8_t sregSaved = SREG;
+  noInterrupts();
+
+#if TIMER_INTERRUPT_TIME_BASE
+  // Counts of the interrupted period, with the old prescaler
+  uint32_t countsElapsed = 0;
+#endif
+
+  // New prescaler, count from 0, and clear any stale compare flag (by writing 1) so that the new interval starts now
+  switch (_timer)
+  {
+#if TIMER_REGISTERS_1
+
+    case 1:
+  #if TIMER_INTERRUPT_TIME_BASE
+      countsElapsed = TimerRegisters<1>::getCount() + ( TimerRegisters<1>::isInterruptPending() ? _currentOCR + 1 : 0 );
+  #endif
+      TimerRegisters<1>::setPrescaler(prescalerIndex);
+      TimerRegisters<1>::resetCount();
+      TimerRegisters<1>::clearInterruptFlag();
+      break;
+#endif
+
+#if TIMER_REGISTERS_2
+
+    case 2:
+  #if TIMER_INTERRUPT_TIME_BASE
+      countsElapsed = TimerRegisters<2>::getCount() + ( TimerRegisters<2>::isInterruptPending() ? _currentOCR + 1 : 0 );
+  #endif
+      TimerRegisters<2>::setPrescaler(prescalerIndex);
+      TimerRegisters<2>::resetCount();
+      TimerRegisters<2>::clearInterruptFlag();
+      break;
+#endif
+
+#if TIMER_REGISTERS_3
+
+    case 3:
+  #if TIMER_INTERRUPT_TIME_BASE
+      countsElapsed = TimerRegisters<3>::getCount() + ( TimerRegisters<3>::isInterruptPending() ? _currentOCR + 1 : 0 );
+  #endif
+      TimerRegisters<3>::setPrescaler(prescalerIndex);
+      TimerRegisters<3>::resetCount();
+      TimerRegisters<3>::clearInterruptFlag();
+      break;
+#endif
+
+#if TIMER_REGISTERS_4
+
+    case 4:
+  #if TIMER_INTERRUPT_TIME_BASE
+      countsElapsed = TimerRegisters<4>::getCount() + ( TimerRegisters<4>::isInterruptPending() ? _currentOCR + 1 : 0 );
+  #endif
+      TimerRegisters<4>::setPrescaler(prescalerIndex);
+      TimerRegisters<4>::resetCount();
+      TimerRegisters<4>::clearInterruptFlag();
+      break;
+#endif
+
+#if TIMER_REGISTERS_5
+
+    case 5:
+  #if TIMER_INTERRUPT_TIME_BASE
+      countsElapsed = TimerRegisters<5>::getCount() + ( TimerRegisters<5>::isInterruptPending() ? _currentOCR + 1 : 0 );
+  #endif
+      TimerRegisters<5>::setPrescaler(prescalerIndex);
+      TimerRegisters<5>::resetCount();
+      TimerRegisters<5>::clearInterruptFlag();
+      break;
+#endif
+  }
+
+#if TIMER_INTERRUPT_TIME_BASE
+  addElapsedCycles(countsElapsed * getPrescalerDiv());
+#endif
+
+  _prescalerIndex     = prescalerIndex;
+  _OCRValue           = counts - 1;
+  _ditherStep         = 0;
+  _isPeriodPending    = false;
+
+  planChunks();
+  _timerDone          = false;
+
+  // Load OCR with the first chunk and enable the compare interrupt
+  set_OCR();
+
+  SREG = sregSaved;
+}
+
+// The compares of the period already elapsed are skipped, then the counter is preset within the current one.
+// A count written equal to OCR would block its compare match, so such a phase comes 1 count later
+void TimerInterrupt::restartPeriod(uint32_t phaseCounts)
+{
+  uint32_t  counts  = _OCRValue + 1;
+  uint32_t  skip    = (counts - phaseCounts % counts) % counts;
+  uint32_t  countsToUse;
+
+  uint8_t sregSaved = SREG;
+  noInterrupts();
+
+  planChunks();
+  _timerDone = false;
+
+  // Whole compares already elapsed, see set_OCR()
+  for ( ; ; )
+  {
+    countsToUse = (_OCRValueRemaining > _shortChunksCounts) ? _chunkCounts + 1 : _chunkCounts;
+
+    if (skip < countsToUse)
+      break;
+
+    _OCRValueRemaining  -= countsToUse;
+    skip                -= countsToUse;
+  }
+
+  if ( (skip == countsToUse - 1) && (skip > 0) )
+    skip--;
+
+  uint16_t count = skip;
+
+  set_OCR();
+
+  switch (_timer)
+  {
+#if TIMER_REGISTERS_1
+
+    case 1:
+      TimerRegisters<1>::setCount(count);
+      TimerRegisters<1>::clearInterruptFlag();
+      break;
+#endif
+
+#if TIMER_REGISTERS_2
+
+    case 2:
+      TimerRegisters<2>::setCount(count);
+      TimerRegisters<2>::clearInterruptFlag();
+      break;
+#endif
+
+#if TIMER_REGISTERS_3
+
+    case 3:
+      TimerRegisters<3>::setCount(count);
+      TimerRegisters<3>::clearInterruptFlag();
+      break;
+#endif
+
+#if TIMER_REGISTERS_4
+
+    case 4:
+      TimerRegisters<4>::setCount(count);
+      TimerRegisters<4>::clearInterruptFlag();
+      break;
+#endif
+
+#if TIMER_REGISTERS_5
+
+    case 5:
+      TimerRegisters<5>::setCount(count);
+      TimerRegisters<5>::clearInterruptFlag();
+      break;
+#endif
+  }
+
+  SREG = sregSaved;
+}
+
+// Buffered for apply_Period(), which loads the new OCR right after the compare ending the running period. So the
+// ISR must get there before the counter, restarted from 0, passes it
+bool TimerInterrupt::queuePeriod(uint8_t prescalerIndex, uint32_t OCRValue, uint32_t num, uint32_t den)
+{
+  // in timer clock cycles
+  uint32_t minCycles = mulDiv(TIMER_INTERRUPT_ISR_CYCLES, getTimerClock(), F_CPU);
+
+  if ( (OCRValue < 0xFFFF) && ( (OCRValue + 1) * getPrescalerDiv(prescalerIndex) < minCycles ) )
+  {
+    TISR_LOGWARN1(F("setPeriodAsync: period too short for T"), _timer);
+
+    return false;
+  }
+
+  uint8_t sregSaved = SREG;
+  noInterrupts();
+
+  _pendingPrescalerIndex  = prescalerIndex;
+  _pendingOCRValue        = OCRValue;
+  _pendingFrequencyNum    = num;
+  _pendingFrequencyDen    = den;
+  _isPeriodPending        = true;
+
+  SREG = sregSaved;
+
+  return true;
+}
+
+bool TimerInterrupt::setPeriodAsync(unsigned long periodMicros)
+{
+  uint32_t  maxCount        = getMaxCount() + 1;
+  uint8_t   prescalerIndex  = _prescalerIndex;
+  uint32_t  OCRValue;
+
+  if ( (_timer <= 0) || (periodMicros == 0) )
+    return false;
+
+  // Counts of the running prescaler
+  uint32_t  counts  = roundedCounts(1000000UL, periodMicros, prescalerIndex);
+  bool      isKept;
+
+  if (counts <= maxCount)
+  {
+    // Same choice as setNextInterval(): the smallest prescaler fitting one compare
+    isKept = (prescalerIndex == NO_PRESCALER) || (roundedCounts(1000000UL, periodMicros, prescalerIndex - 1) > maxCount);
+  }
+  else
+  {
+    // Retuning a long period
+    isKept = (_numChunks > 1) && (counts < 0xFFFFFFFFUL);
+  }
+
+  if (isKept)
+  {
+    OCRValue = counts - 1;
+  }
+  else if (!planFrequency(1000000UL, periodMicros, prescalerIndex, OCRValue))
+  {
+    TISR_LOGWARN1(F("setPeriodAsync: period out of range of T"), _timer);
 
-      break;
-#endif
+    return false;
+  }
 
-#if defined(TCCR5A) && defined(TCCR5B) &&  defined(TIMSK5)
+  return queuePeriod(prescalerIndex, OCRValue, 1000000UL, periodMicros);
+}
 
-    case 5:
-      // 16 bit timer
-      TCCR5A = 0;
-      TCCR5B = 0;
-      bitWrite(TCCR5B, WGM52, 1);
-      bitWrite(TCCR5B, CS50, 1);
+bool TimerInterrupt::setPeriodTicksAsync(uint32_t periodTicks)
+{
+  if ( (_timer <= 0) || (periodTicks == 0) )
+    return false;
 
-      TISR_LOGWARN(F("T5"));
+  // Frequency of getTimerClock() / (periodTicks * div) Hz, kept for getErrorPpm() and reattachInterrupt(duration).
+  // The prescaler divisions being powers of 2, they're first reduced with the clock, which is exact for most clocks
+  uint32_t  num = getTimerClock();
+  uint32_t  div = getPrescalerDiv();
 
-      break;
-#endif
+  while ( (div > 1) && !(num & 1) )
+  {
+    num >>= 1;
+    div >>= 1;
   }
 
-  _timer = timer;
+  // Then, for the longest periods only, the frequency is rounded to fit den in 32 bits
+  uint32_t  ticks = periodTicks;
 
-  //sei();//enable interrupts
-  interrupts();
+  while (ticks > 0xFFFFFFFFUL / div)
+  {
+    num   = (num + 1) >> 1;
+    ticks = (ticks >> 1) + (ticks & 1);
+  }
 
+  return queuePeriod(_prescalerIndex, periodTicks - 1, num, ticks * div);
 }
 
-void TimerInterrupt::set_OCR()
+#if TIMER_INTERRUPT_TIME_BASE
+
+// Time base, in us, counted by this timer's own interrupts and extended by its counter TCNTx.
+// Only valid while the timer is running
+unsigned long TimerInterrupt::getMicros()
 {
-  // Run with noInterrupt()
-  // Set the OCR for the given timer,
-  // set the toggle count,
-  // then turn on the interrupts
-  uint32_t _OCRValueToUse;
+  uint32_t  countsElapsed = 0;
+  uint8_t   sregSaved     = SREG;
+
+  noInterrupts();
+
+  uint32_t  micros        = _elapsedMicros;
+  uint8_t   cycles        = _elapsedCycles;
 
+  // If a compare match is pending, its interrupt hasn't counted the ended period yet.
+  // Read TCNTx again after the flag, as it may have just been reset to 0
   switch (_timer)
   {
+#if TIMER_REGISTERS_1
+
     case 1:
-      _OCRValueToUse = min(MAX_COUNT_16BIT, _OCRValueRemaining);
-      OCR1A = _OCRValueToUse;
-      _OCRValueRemaining -= _OCRValueToUse;
+      countsElapsed = TimerRegisters<1>::getCount();
+
+      if (TimerRegisters<1>::isInterruptPending())
+        countsElapsed = TimerRegisters<1>::getCount() + _currentOCR + 1;
 
-#if defined(OCR1A) && defined(TIMSK1) && defined(OCIE1A)
-      // Bit 1 – OCIEA: Output Compare A Match Interrupt Enable
-      // When this bit is written to '1', and the I-flag in the Status Register is set (interrupts globally enabled), the
-      // Timer/Counter Output Compare A Match interrupt is enabled. The corresponding Interrupt Vector is
-      // executed when the OCFA Flag, located in TIFR1, is set.
-      bitWrite(TIMSK1, OCIE1A, 1);
-#elif defined(OCR1A) && defined(TIMSK) && defined(OCIE1A)
-      // this combination is for at least the ATmega32
-      bitWrite(TIMSK, OCIE1A, 1);
-#endif
       break;
+#endif
 
-#if defined(OCR2A) && defined(TIMSK2) && defined(OCIE2A)
+#if TIMER_REGISTERS_2
 
     case 2:
-      _OCRValueToUse = min(MAX_COUNT_8BIT, _OCRValueRemaining);
-      OCR2A = _OCRValueToUse;
-      _OCRValueRemaining -= _OCRValueToUse;
+      countsElapsed = TimerRegisters<2>::getCount();
+
+      if (TimerRegisters<2>::isInterruptPending())
+        countsElapsed = TimerRegisters<2>::getCount() + _currentOCR + 1;
 
-      bitWrite(TIMSK2, OCIE2A, 1);
       break;
 #endif
 
-#if defined(OCR3A) && defined(TIMSK3) && defined(OCIE3A)
+#if TIMER_REGISTERS_3
 
     case 3:
-      _OCRValueToUse = min(MAX_COUNT_16BIT, _OCRValueRemaining);
-      OCR3A = _OCRValueToUse;
-      _OCRValueRemaining -= _OCRValueToUse;
+      countsElapsed = TimerRegisters<3>::getCount();
+
+      if (TimerRegisters<3>::isInterruptPending())
+        countsElapsed = TimerRegisters<3>::getCount() + _currentOCR + 1;
 
-      bitWrite(TIMSK3, OCIE3A, 1);
       break;
 #endif
 
-#if defined(OCR4A) && defined(TIMSK4) && defined(OCIE4A)
+#if TIMER_REGISTERS_4
 
     case 4:
+      countsElapsed = TimerRegisters<4>::getCount();
 
-#if TIMER_INTERRUPT_USING_ATMEGA_32U4
-      _OCRValueToUse = min(MAX_COUNT_8BIT, _OCRValueRemaining);
-#else
-      _OCRValueToUse = min(MAX_COUNT_16BIT, _OCRValueRemaining);
-#endif
-
-      OCR4A = _OCRValueToUse;
-      _OCRValueRemaining -= _OCRValueToUse;
+      if (TimerRegisters<4>::isInterruptPending())
+        countsElapsed = TimerRegisters<4>::getCount() + _currentOCR + 1;
 
-      bitWrite(TIMSK4, OCIE4A, 1);
       break;
 #endif
 
-#if defined(OCR5A) && defined(TIMSK5) && defined(OCIE5A)
+#if TIMER_REGISTERS_5
 
     case 5:
-      _OCRValueToUse = min(MAX_COUNT_16BIT, _OCRValueRemaining);
-      OCR5A = _OCRValueToUse;
-      _OCRValueRemaining -= _OCRValueToUse;
+      countsElapsed = TimerRegisters<5>::getCount();
+
+      if (TimerRegisters<5>::isInterruptPending())
+        countsElapsed = TimerRegisters<5>::getCount() + _currentOCR + 1;
 
-      bitWrite(TIMSK5, OCIE5A, 1);
       break;
 #endif
   }
 
-  // Flag _OCRValue == 0 => end of long timer
-  if (_OCRValueRemaining == 0)
-    _timerDone = true;
+  SREG = sregSaved;
 
+  return micros + (cycles + countsElapsed * getPrescalerDiv()) / clockCyclesPerMicrosecond();
 }
 
-// frequency (in hertz) and duration (in milliseconds).
-// Return true if frequency is OK with selected timer (OCRValue is in range)
-bool TimerInterrupt::setFrequency(float frequency, timer_callback_p callback, uint32_t params, unsigned long duration)
-{
-  uint8_t       andMask = 0b11111000;
-  unsigned long OCRValue;
-  bool isSuccess = false;
-
-  //frequencyLimit must > 1
-  float frequencyLimit = frequency * 17179.840;
-
-  // Limit frequency to larger than (0.00372529 / 64) Hz or interval 17179.840s / 17179840 ms to avoid uint32_t overflow
-  if ((_timer <= 0) || (callback == NULL) || ((frequencyLimit) < 1) )
-  {
-    return false;
-  }
-  else
-  {
-    // Calculate the toggle count. Duration must be at least longer then one cycle
-    if (duration > 0)
-    {
-      _toggle_count = frequency * duration / 1000;
-
-      TISR_LOGWARN1(F("setFrequency => _toggle_count ="), _toggle_count);
-      TISR_LOGWARN3(F("Frequency ="), frequency, F(", duration ="), duration);
-
-      if (_toggle_count < 1)
-      {
-        return false;
-      }
-    }
-    else
-    {
-      _toggle_count = -1;
-    }
-
-    //Timer0 and timer2 are 8 bit timers, meaning they can store a maximum counter value of 255.
-    //Timer2 does not have the option of 1024 prescaler, only 1, 8, 32, 64
-    //Timer1 is a 16 bit timer, meaning it can store a maximum counter value of 65535.
-    int prescalerIndexStart;
-
-    //Use smallest prescaler first, then increase until fits (<255)
-    if (_timer != 2)
-    {
-      if (frequencyLimit > 64)
-        prescalerIndexStart = NO_PRESCALER;
-      else if (frequencyLimit > 8)
-        prescalerIndexStart = PRESCALER_8;
-      else
-        prescalerIndexStart = PRESCALER_64;
-
-
-      for (int prescalerIndex = prescalerIndexStart; prescalerIndex <= PRESCALER_1024; prescalerIndex++)
-      {
-        OCRValue = F_CPU / (frequency * prescalerDiv[prescalerIndex]) - 1;
-
-        TISR_LOGWARN1(F("Freq * 1000 ="), frequency * 1000);
-        TISR_LOGWARN3(F("F_CPU ="), F_CPU, F(", preScalerDiv ="), prescalerDiv[prescalerIndex]);
-        TISR_LOGWARN3(F("OCR ="), OCRValue, F(", preScalerIndex ="), prescalerIndex);
+#endif    // #if TIMER_INTERRUPT_TIME_BASE
 
-        // We use very large _OCRValue now, and every time timer ISR activates, we deduct min(MAX_COUNT_16BIT, _OCRValueRemaining) from _OCRValueRemaining
-        // So that we can create very long timer, even if the counter is only 16-bit.
-        // Use very high frequency (OCRValue / MAX_COUNT_16BIT) around 16 * 1024 to achieve higher accuracy
-#if TIMER_INTERRUPT_USING_ATMEGA_32U4
-        uint16_t MAX_COUNT_32U4 = (_timer == 4) ? MAX_COUNT_8BIT : MAX_COUNT_16BIT;
-
-        if ( (OCRValue / MAX_COUNT_32U4) < 16384 )
-#else
-        if ( (OCRValue / MAX_COUNT_16BIT) < 16384 )
-#endif
-        {
-          _OCRValue           = OCRValue;
-          _OCRValueRemaining  = OCRValue;
-          _prescalerIndex = prescalerIndex;
-
-          TISR_LOGWARN1(F("OK in loop => _OCR ="), _OCRValue);
-          TISR_LOGWARN3(F("_preScalerIndex ="), _prescalerIndex, F(", preScalerDiv ="), prescalerDiv[_prescalerIndex]);
-
-          isSuccess = true;
-
-          break;
-        }
-      }
-
-      if (!isSuccess)
-      {
-        // Always do this
-        _OCRValue           = OCRValue;
-        _OCRValueRemaining  = OCRValue;
-        _prescalerIndex = PRESCALER_1024;
-
-        TISR_LOGWARN1(F("OK out loop => _OCR ="), _OCRValue);
-        TISR_LOGWARN3(F("_preScalerIndex ="), _prescalerIndex, F(", preScalerDiv ="), prescalerDiv[_prescalerIndex]);
-      }
-    }
-    else
-    {
-      if (frequencyLimit > 64)
-        prescalerIndexStart = T2_NO_PRESCALER;
-      else if (frequencyLimit > 8)
-        prescalerIndexStart = T2_PRESCALER_8;
-      else if (frequencyLimit > 2)
-        prescalerIndexStart = T2_PRESCALER_32;
-      else
-        prescalerIndexStart = T2_PRESCALER_64;
+// Error (in ppm) of the actual period vs. the one of the last setFrequency(). Integer math only
+long TimerInterrupt::getErrorPpm()
+{
+  if (_frequencyNum == 0)
+    return 0;
 
-      // Page 206-207. ATmegal328
-      //8-bit Timer2 has more options up to 1024 prescaler, from 1, 8, 32, 64, 128, 256 and 1024
-      for (int prescalerIndex = prescalerIndexStart; prescalerIndex <= T2_PRESCALER_1024; prescalerIndex++)
-      {
-        OCRValue = F_CPU / (frequency * prescalerDivT2[prescalerIndex]) - 1;
+  // Requested period, in counts and 1 / 2^32 count
+  uint32_t  fraction;
+  uint32_t  counts  = periodCounts(_frequencyNum, _frequencyDen, _prescalerIndex, fraction);
 
-        TISR_LOGWARN3(F("F_CPU ="), F_CPU, F(", preScalerDiv ="), prescalerDivT2[prescalerIndex]);
-        TISR_LOGWARN3(F("OCR2 ="), OCRValue, F(", preScalerIndex ="), prescalerIndex);
+  // In 1 / 2^shift count, the finest resolution with the requested period in 30 bits
+  uint8_t   shift   = 30;
 
-        // We use very large _OCRValue now, and every time timer ISR activates, we deduct min(MAX_COUNT_8BIT, _OCRValue) from _OCRValue
-        // to create very long timer, even if the counter is only 16-bit.
-        // Use very high frequency (OCRValue / MAX_COUNT_8BIT) around 16 * 1024 to achieve higher accuracy
-        if ( (OCRValue / MAX_COUNT_8BIT) < 16384 )
-        {
-          _OCRValue           = OCRValue;
-          _OCRValueRemaining  = OCRValue;
-          // same as prescalarbits
-          _prescalerIndex = prescalerIndex;
+  while ( (shift > 0) && (counts >> (30 - shift)) )
+    shift--;
 
-          TISR_LOGWARN1(F("OK in loop => _OCR ="), _OCRValue);
-          TISR_LOGWARN3(F("_preScalerIndex ="), _prescalerIndex, F(", preScalerDiv ="), prescalerDivT2[_prescalerIndex]);
+  uint32_t  requested = (counts << shift) | (shift ? fraction >> (32 - shift) : 0);
 
-          isSuccess = true;
+  if (requested == 0)
+    return 0;
 
-          break;
-        }
-      }
+  // Actual (the average of the dithered periods) - requested, within a few counts
+  long      ticks   = (long) getPeriodTicks() - (long) counts;
+  long      limit   = 1L << (30 - shift);
 
-      if (!isSuccess)
-      {
-        // Always do this
-        _OCRValue           = OCRValue;
-        _OCRValueRemaining  = OCRValue;
-        // same as prescalarbits
-        _prescalerIndex = T2_PRESCALER_1024;
-
-        TISR_LOGWARN1(F("OK out loop => _OCR ="), _OCRValue);
-        TISR_LOGWARN3(F("_preScalerIndex ="), _prescalerIndex, F(", preScalerDiv ="), prescalerDivT2[_prescalerIndex]);
-      }
-    }
+  if ( (ticks > limit) || (ticks < -limit) )
+    ticks = (ticks > 0) ? limit : -limit;
 
-    //cli();//stop interrupts
-    noInterrupts();
+  long      diff    = ticks * (1L << shift);
 
-    _frequency = frequency;
-    _callback  = (void*) callback;
-    _params    = reinterpret_cast<void*>(params);
+  if (shift)
+    diff += (long) (_ditherStep >> (32 - shift)) - (long) (fraction >> (32 - shift));
 
-    _timerDone = false;
+  uint32_t  ppm     = mulDiv( (diff < 0) ? -diff : diff, 1000000UL, requested );
 
-    // 8 bit timers from here
-#if defined(TCCR2B)
+  ppm = min(ppm, 0x7FFFFFFFUL);
 
-    if (_timer == 2)
-    {
-      TCCR2B = (TCCR2B & andMask) | _prescalerIndex;   //prescalarbits;
+  return (diff < 0) ? - (long) ppm : (long) ppm;
+}
 
-      TISR_LOGWARN1(F("TCCR2B ="), TCCR2B);
-    }
+bool TimerInterrupt::isEnabled()
+{
+  switch (_timer)
+  {
+#if TIMER_REGISTERS_1
 
+    case 1:
+      return TimerRegisters<1>::isInterruptEnabled();
 #endif
 
-    // 16 bit timers from here
-#if defined(TCCR1B)
-#if ( TIMER_INTERRUPT_USING_ATMEGA_32U4 )
+#if TIMER_REGISTERS_2
 
-    if (_timer == 1)
-#else
-    else if (_timer == 1)
+    case 2:
+      return TimerRegisters<2>::isInterruptEnabled();
 #endif
-    {
-      TCCR1B = (TCCR1B & andMask) | _prescalerIndex;   //prescalarbits;
 
-      TISR_LOGWARN1(F("TCCR1B ="), TCCR1B);
-    }
+#if TIMER_REGISTERS_3
 
+    case 3:
+      return TimerRegisters<3>::isInterruptEnabled();
 #endif
 
-#if defined(TCCR3B)
-    else if (_timer == 3)
-      TCCR3B = (TCCR3B & andMask) | _prescalerIndex;   //prescalarbits;
+#if TIMER_REGISTERS_4
 
+    case 4:
+      return TimerRegisters<4>::isInterruptEnabled();
 #endif
 
-#if defined(TCCR4B)
-    else if (_timer == 4)
-      TCCR4B = (TCCR4B & andMask) | _prescalerIndex;   //prescalarbits;
+#if TIMER_REGISTERS_5
 
+    case 5:
+      return TimerRegisters<5>::isInterruptEnabled();
 #endif
+  }
 
-#if defined(TCCR5B)
-    else if (_timer == 5)
-      TCCR5B = (TCCR5B & andMask) | _prescalerIndex;   //prescalarbits;
-
-#endif
+  return false;
+}
 
-    // Set the OCR for the given timer,
-    // set the toggle count,
-    // then turn on the interrupts
-    set_OCR();
+// Such as "Timer1 : prescaler 64, OCR 249, 1000.000 Hz, error 0 ppm, 1 wake-up(s) per period, ISR load ~0.75 %"
+// The ISR load is estimated with TIMER_INTERRUPT_ISR_CYCLES per wake-up, the callbacks aren't included
+void TimerInterrupt::printReport(Print& out)
+{
+  // In 1/100 %: _numChunks * TIMER_INTERRUPT_ISR_CYCLES * 10000 * timer clock / (ticks * prescaler * F_CPU)
+  uint32_t load = mulDiv(_numChunks * TIMER_INTERRUPT_ISR_CYCLES, mulDiv(10000, getTimerClock(), F_CPU), getPeriodTicks())
+                  / getPrescalerDiv();
 
-    //sei();//allow interrupts
-    interrupts();
+  out.print(F("Timer"));              out.print((int) _timer);
 
-    return true;
+  if (!isEnabled())
+  {
+    out.println(F(" : interrupt disabled"));
+    return;
   }
+
+  out.print(F(" : prescaler "));      out.print(getPrescalerDiv());
+  out.print(F(", OCR "));             out.print(_OCRValue);
+  if (isDithering())
+    out.print(F(" dithered"));
+  out.print(F(", "));                 out.print(getActualFrequency(), 3);
+  out.print(F(" Hz, error "));        out.print(getErrorPpm());
+  out.print(F(" ppm, "));             out.print(_numChunks);
+  out.print(F(" wake-up(s) per period, ISR load ~"));
+  out.print(load / 100);              out.print(F("."));
+  if ((load % 100) < 10)
+    out.print(F("0"));
+  out.print(load % 100);              out.println(F(" %"));
 }
 
 void TimerInterrupt::detachInterrupt(void)
@@ -454,56 +1384,44 @@ void TimerInterrupt::detachInterrupt(void)
 
   switch (_timer)
   {
-#if defined(TIMSK1) && defined(OCIE1A)
+#if TIMER_REGISTERS_1
 
     case 1:
-      bitWrite(TIMSK1, OCIE1A, 0);
-
-      TISR_LOGWARN(F("Disable T1"));
-
+      TimerRegisters<1>::disableInterrupt();
       break;
 #endif
 
-    case 2:
-#if defined(TIMSK2) && defined(OCIE2A)
-      bitWrite(TIMSK2, OCIE2A, 0); // disable interrupt
-#endif
-
-      TISR_LOGWARN(F("Disable T2"));
+#if TIMER_REGISTERS_2
 
+    case 2:
+      TimerRegisters<2>::disableInterrupt();
       break;
+#endif
 
-#if defined(TIMSK3) && defined(OCIE3A)
+#if TIMER_REGISTERS_3
 
     case 3:
-      bitWrite(TIMSK3, OCIE3A, 0);
-
-      TISR_LOGWARN(F("Disable T3"));
-
+      TimerRegisters<3>::disableInterrupt();
       break;
 #endif
 
-#if defined(TIMSK4) && defined(OCIE4A)
+#if TIMER_REGISTERS_4
 
     case 4:
-      bitWrite(TIMSK4, OCIE4A, 0);
-
-      TISR_LOGWARN(F("Disable T4"));
-
+      TimerRegisters<4>::disableInterrupt();
       break;
 #endif
 
-#if defined(TIMSK5) && defined(OCIE5A)
+#if TIMER_REGISTERS_5
 
     case 5:
-      bitWrite(TIMSK5, OCIE5A, 0);
-
-      TISR_LOGWARN(F("Disable T5"));
-
+      TimerRegisters<5>::disableInterrupt();
       break;
 #endif
   }
 
+  TISR_LOGWARN1(F("Disable T"), _timer);
+
   //sei();//allow interrupts
   interrupts();
 }
@@ -517,7 +1435,7 @@ void TimerInterrupt::reattachInterrupt(unsigned long duration)
   // Calculate the toggle count
   if (duration > 0)
   {
-    _toggle_count = _frequency * duration / 1000;
+    _toggle_count = countPeriods(_frequencyNum, _frequencyDen, duration);
   }
   else
   {
@@ -526,56 +1444,44 @@ void TimerInterrupt::reattachInterrupt(unsigned long duration)
 
   switch (_timer)
   {
-#if defined(TIMSK1) && defined(OCIE1A)
+#if TIMER_REGISTERS_1
 
     case 1:
-      bitWrite(TIMSK1, OCIE1A, 1);
-
-      TISR_LOGWARN(F("Enable T1"));
-
+      TimerRegisters<1>::enableInterrupt();
       break;
 #endif
 
-    case 2:
-#if defined(TIMSK2) && defined(OCIE2A)
-      bitWrite(TIMSK2, OCIE2A, 1); // enable interrupt
-#endif
-
-      TISR_LOGWARN(F("Enable T2"));
+#if TIMER_REGISTERS_2
 
+    case 2:
+      TimerRegisters<2>::enableInterrupt();
       break;
+#endif
 
-#if defined(TIMSK3) && defined(OCIE3A)
+#if TIMER_REGISTERS_3
 
     case 3:
-      bitWrite(TIMSK3, OCIE3A, 1);
-
-      TISR_LOGWARN(F("Enable T3"));
-
+      TimerRegisters<3>::enableInterrupt();
       break;
 #endif
 
-#if defined(TIMSK4) && defined(OCIE4A)
+#if TIMER_REGISTERS_4
 
     case 4:
-      bitWrite(TIMSK4, OCIE4A, 1);
-
-      TISR_LOGWARN(F("Enable T4"));
-
+      TimerRegisters<4>::enableInterrupt();
       break;
 #endif
 
-#if defined(TIMSK5) && defined(OCIE5A)
+#if TIMER_REGISTERS_5
 
     case 5:
-      bitWrite(TIMSK5, OCIE5A, 1);
-
-      TISR_LOGWARN(F("Enable T5"));
-
+      TimerRegisters<5>::enableInterrupt();
       break;
 #endif
   }
 
+  TISR_LOGWARN1(F("Enable T"), _timer);
+
   //sei();//allow interrupts
   interrupts();
 }
@@ -583,108 +1489,15 @@ void TimerInterrupt::reattachInterrupt(unsigned long duration)
 // Just stop clock source, still keep the count
 void TimerInterrupt::pauseTimer(void)
 {
-  uint8_t andMask = 0b11111000;
-
   //Just clear the CSx2-CSx0. Still keep the count in TCNT and Timer Interrupt mask TIMKSx.
-
-  // 8 bit timers from here
-#if defined(TCCR2B)
-
-  if (_timer == 2)
-  {
-    TCCR2B = (TCCR2B & andMask);
-
-    TISR_LOGWARN1(F("TCCR2B ="), TCCR2B);
-  }
-
-#endif
-
-  // 16 bit timers from here
-#if defined(TCCR1B)
-#if ( TIMER_INTERRUPT_USING_ATMEGA_32U4 )
-
-  if (_timer == 1)
-#else
-  else if (_timer == 1)
-#endif
-  {
-    TCCR1B = (TCCR1B & andMask);
-
-    TISR_LOGWARN1(F("TCCR1B ="), TCCR1B);
-  }
-
-#endif
-
-#if defined(TCCR3B)
-  else if (_timer == 3)
-    TCCR3B = (TCCR3B & andMask);
-
-#endif
-
-#if defined(TCCR4B)
-  else if (_timer == 4)
-    TCCR4B = (TCCR4B & andMask);
-
-#endif
-
-#if defined(TCCR5B)
-  else if (_timer == 5)
-    TCCR5B = (TCCR5B & andMask);
-
-#endif
+  setPrescaler(0);
 }
 
 // Just reconnect clock source, continue from the current count
 void TimerInterrupt::resumeTimer(void)
 {
-  uint8_t andMask = 0b11111000;
-
   //Just restore the CSx2-CSx0 stored in _prescalerIndex. Still keep the count in TCNT and Timer Interrupt mask TIMKSx.
-  // 8 bit timers from here
-#if defined(TCCR2B)
-
-  if (_timer == 2)
-  {
-    TCCR2B = (TCCR2B & andMask) | _prescalerIndex;   //prescalarbits;
-
-    TISR_LOGWARN1(F("TCCR2B ="), TCCR2B);
-  }
-
-#endif
-
-  // 16 bit timers from here
-#if defined(TCCR1B)
-#if ( TIMER_INTERRUPT_USING_ATMEGA_32U4 )
-
-  if (_timer == 1)
-#else
-  else if (_timer == 1)
-#endif
-  {
-    TCCR1B = (TCCR1B & andMask) | _prescalerIndex;   //prescalarbits;
-
-    TISR_LOGWARN1(F("TCCR1B ="), TCCR1B);
-  }
-
-#endif
-
-#if defined(TCCR3B)
-  else if (_timer == 3)
-    TCCR3B = (TCCR3B & andMask) | _prescalerIndex;   //prescalarbits;
-
-#endif
-
-#if defined(TCCR4B)
-  else if (_timer == 4)
-    TCCR4B = (TCCR4B & andMask) | _prescalerIndex;   //prescalarbits;
-
-#endif
-
-#if defined(TCCR5B)
-  else if (_timer == 5)
-    TCCR5B = (TCCR5B & andMask) | _prescalerIndex;   //prescalarbits;
-
-#endif
+  setPrescaler(_prescalerIndex);
 }
 
 
@@ -699,6 +1512,17 @@ static TimerInterrupt ITimer1(HW_TIMER_1);
 
 ISR(TIMER1_COMPA_vect)
 {
+#if TIMER_INTERRUPT_TIME_BASE
+  // Count the ended compare period first, so that callbacks see the current time
+  ITimer1.updateTimeBase<HW_TIMER_1>();
+#endif
+
+  if (ITimer1.isPeriodPending())
+    ITimer1.apply_Period<HW_TIMER_1>();
+
+  if (ITimer1.isDithering())
+    ITimer1.dither_OCRValue<HW_TIMER_1>();
+
   long countLocal = ITimer1.getCount();
 
   if (ITimer1.getTimer() == 1)
@@ -711,10 +1535,10 @@ ISR(TIMER1_COMPA_vect)
 
         ITimer1.callback();
 
-        if (ITimer1.get_OCRValue() > MAX_COUNT_16BIT)
+        if (ITimer1.get_OCRValue() > TimerRegisters<HW_TIMER_1>::MAX_COUNT)
         {
-          // To reload _OCRValueRemaining as well as _OCR register to MAX_COUNT_16BIT if _OCRValueRemaining > MAX_COUNT_16BIT
-          ITimer1.reload_OCRValue();
+          // Long timer: restart the period with its first compare
+          ITimer1.reload_OCRValue<HW_TIMER_1>();
         }
 
         if (countLocal > 0)
@@ -722,10 +1546,8 @@ ISR(TIMER1_COMPA_vect)
       }
       else
       {
-        //Deduct _OCRValue by min(MAX_COUNT_16BIT, _OCRValue)
-        // If _OCRValue == 0, flag _timerDone for next cycle
-        // If last one (_OCRValueRemaining < MAX_COUNT_16BIT) => load _OCR register _OCRValueRemaining
-        ITimer1.adjust_OCRValue();
+        // Intermediate compare of a long timer: load the next one, and flag _timerDone if it's the last
+        ITimer1.adjust_OCRValue<HW_TIMER_1>();
       }
     }
     else
@@ -747,6 +1569,17 @@ static TimerInterrupt ITimer2(HW_TIMER_2);
 
 ISR(TIMER2_COMPA_vect)
 {
+#if TIMER_INTERRUPT_TIME_BASE
+  // Count the ended compare period first, so that callbacks see the current time
+  ITimer2.updateTimeBase<HW_TIMER_2>();
+#endif
+
+  if (ITimer2.isPeriodPending())
+    ITimer2.apply_Period<HW_TIMER_2>();
+
+  if (ITimer2.isDithering())
+    ITimer2.dither_OCRValue<HW_TIMER_2>();
+
   long countLocal = ITimer2.getCount();
 
   if (ITimer2.getTimer() == 2)
@@ -759,10 +1592,10 @@ ISR(TIMER2_COMPA_vect)
 
         ITimer2.callback();
 
-        if (ITimer2.get_OCRValue() > MAX_COUNT_8BIT)
+        if (ITimer2.get_OCRValue() > TimerRegisters<HW_TIMER_2>::MAX_COUNT)
         {
-          // To reload _OCRValueRemaining as well as _OCR register to MAX_COUNT_8BIT if _OCRValueRemaining > MAX_COUNT_8BIT
-          ITimer2.reload_OCRValue();
+          // Long timer: restart the period with its first compare
+          ITimer2.reload_OCRValue<HW_TIMER_2>();
         }
 
         if (countLocal > 0)
@@ -773,7 +1606,7 @@ ISR(TIMER2_COMPA_vect)
       {
         //Deduct _OCRValue by min(MAX_COUNT_8BIT, _OCRValue)
         // If _OCRValue == 0, flag _timerDone for next cycle
-        ITimer2.adjust_OCRValue();
+        ITimer2.adjust_OCRValue<HW_TIMER_2>();
       }
     }
     else
@@ -798,6 +1631,17 @@ static TimerInterrupt ITimer3(HW_TIMER_3);
 
 ISR(TIMER3_COMPA_vect)
 {
+#if TIMER_INTERRUPT_TIME_BASE
+  // Count the ended compare period first, so that callbacks see the current time
+  ITimer3.updateTimeBase<HW_TIMER_3>();
+#endif
+
+  if (ITimer3.isPeriodPending())
+    ITimer3.apply_Period<HW_TIMER_3>();
+
+  if (ITimer3.isDithering())
+    ITimer3.dither_OCRValue<HW_TIMER_3>();
+
   long countLocal = ITimer3.getCount();
 
   if (ITimer3.getTimer() == 3)
@@ -810,10 +1654,10 @@ ISR(TIMER3_COMPA_vect)
 
         ITimer3.callback();
 
-        if (ITimer3.get_OCRValue() > MAX_COUNT_16BIT)
+        if (ITimer3.get_OCRValue() > TimerRegisters<HW_TIMER_3>::MAX_COUNT)
         {
-          // To reload _OCRValueRemaining as well as _OCR register to MAX_COUNT_16BIT if _OCRValueRemaining > MAX_COUNT_16BIT
-          ITimer3.reload_OCRValue();
+          // Long timer: restart the period with its first compare
+          ITimer3.reload_OCRValue<HW_TIMER_3>();
         }
 
         if (countLocal > 0)
@@ -821,10 +1665,8 @@ ISR(TIMER3_COMPA_vect)
       }
       else
       {
-        //Deduct _OCRValue by min(MAX_COUNT_16BIT, _OCRValue)
-        // If _OCRValue == 0, flag _timerDone for next cycle
-        // If last one (_OCRValueRemaining < MAX_COUNT_16BIT) => load _OCR register _OCRValueRemaining
-        ITimer3.adjust_OCRValue();
+        // Intermediate compare of a long timer: load the next one, and flag _timerDone if it's the last
+        ITimer3.adjust_OCRValue<HW_TIMER_3>();
       }
     }
     else
@@ -843,7 +1685,7 @@ ISR(TIMER3_COMPA_vect)
 
 #if (TIMER_INTERRUPT_USING_ATMEGA2560 || TIMER_INTERRUPT_USING_ATMEGA_32U4)
 
-// Even 32u4 Timer4 has 10-bit counter, we use only 8-bit to simplify by not using 2-bit High Byte Register (TC4H)
+// 32u4 Timer4 uses its 10-bit counter, with the 2-bit High Byte Register (TC4H), see TimerRegisters<4>
 // Check 15.2.2 Accuracy, page 141 of ATmega16U4/32U4 [DATASHEET]
 
 #if USE_TIMER_4
@@ -854,6 +1696,17 @@ static TimerInterrupt ITimer4(HW_TIMER_4);
 
 ISR(TIMER4_COMPA_vect)
 {
+#if TIMER_INTERRUPT_TIME_BASE
+  // Count the ended compare period first, so that callbacks see the current time
+  ITimer4.updateTimeBase<HW_TIMER_4>();
+#endif
+
+  if (ITimer4.isPeriodPending())
+    ITimer4.apply_Period<HW_TIMER_4>();
+
+  if (ITimer4.isDithering())
+    ITimer4.dither_OCRValue<HW_TIMER_4>();
+
   long countLocal = ITimer4.getCount();
 
   if (ITimer4.getTimer() == 4)
@@ -866,10 +1719,10 @@ ISR(TIMER4_COMPA_vect)
 
         ITimer4.callback();
 
-        if (ITimer4.get_OCRValue() > MAX_COUNT_16BIT)
+        if (ITimer4.get_OCRValue() > TimerRegisters<HW_TIMER_4>::MAX_COUNT)
         {
-          // To reload _OCRValueRemaining as well as _OCR register to MAX_COUNT_16BIT if _OCRValueRemaining > MAX_COUNT_16BIT
-          ITimer4.reload_OCRValue();
+          // Long timer: restart the period with its first compare
+          ITimer4.reload_OCRValue<HW_TIMER_4>();
         }
 
         if (countLocal > 0)
@@ -880,7 +1733,7 @@ ISR(TIMER4_COMPA_vect)
         //Deduct _OCRValue by min(MAX_COUNT_16BIT, _OCRValue) or min(MAX_COUNT_8BIT, _OCRValue)
         // If _OCRValue == 0, flag _timerDone for next cycle
         // If last one (_OCRValueRemaining < MAX_COUNT_16BIT / MAX_COUNT_8BIT) => load _OCR register _OCRValueRemaining
-        ITimer4.adjust_OCRValue();
+        ITimer4.adjust_OCRValue<HW_TIMER_4>();
       }
     }
     else
@@ -908,6 +1761,17 @@ static TimerInterrupt ITimer5(HW_TIMER_5);
 
 ISR(TIMER5_COMPA_vect)
 {
+#if TIMER_INTERRUPT_TIME_BASE
+  // Count the ended compare period first, so that callbacks see the current time
+  ITimer5.updateTimeBase<HW_TIMER_5>();
+#endif
+
+  if (ITimer5.isPeriodPending())
+    ITimer5.apply_Period<HW_TIMER_5>();
+
+  if (ITimer5.isDithering())
+    ITimer5.dither_OCRValue<HW_TIMER_5>();
+
   long countLocal = ITimer5.getCount();
 
   if (ITimer5.getTimer() == 5)
@@ -920,10 +1784,10 @@ ISR(TIMER5_COMPA_vect)
 
         ITimer5.callback();
 
-        if (ITimer5.get_OCRValue() > MAX_COUNT_16BIT)
+        if (ITimer5.get_OCRValue() > TimerRegisters<HW_TIMER_5>::MAX_COUNT)
         {
-          // To reload _OCRValueRemaining as well as _OCR register to MAX_COUNT_16BIT if _OCRValueRemaining > MAX_COUNT_16BIT
-          ITimer5.reload_OCRValue();
+          // Long timer: restart the period with its first compare
+          ITimer5.reload_OCRValue<HW_TIMER_5>();
         }
 
         if (countLocal > 0)
@@ -931,10 +1795,8 @@ ISR(TIMER5_COMPA_vect)
       }
       else
       {
-        //Deduct _OCRValue by min(MAX_COUNT_16BIT, _OCRValue)
-        // If _OCRValue == 0, flag _timerDone for next cycle
-        // If last one (_OCRValueRemaining < MAX_COUNT_16BIT) => load _OCR register _OCRValueRemaining
-        ITimer5.adjust_OCRValue();
+        // Intermediate compare of a long timer: load the next one, and flag _timerDone if it's the last
+        ITimer5.adjust_OCRValue<HW_TIMER_5>();
       }
     }
     else
@@ -951,4 +1813,30 @@ ISR(TIMER5_COMPA_vect)
 
 #endif      //#if TIMER_INTERRUPT_USING_ATMEGA2560
 
+// printReport() of every ITimerN enabled by USE_TIMER_N
+void printTimerReport(Print& out)
+{
+  (void) out;
+
+#if USE_TIMER_1
+  ITimer1.printReport(out);
+#endif
+
+#if USE_TIMER_2
+  ITimer2.printReport(out);
+#endif
+
+#if USE_TIMER_3
+  ITimer3.printReport(out);
+#endif
+
+#if USE_TIMER_4
+  ITimer4.printReport(out);
+#endif
+
+#if USE_TIMER_5
+  ITimer5.printReport(out);
+#endif
+}
+
 #endif // TimerInterrupt_Impl_h
@@ -115,6 +115,17 @@
   #define TIMER_INTERRUPT_DEBUG      0
 #endif
 
+// Keep a us time base in each TimerInterrupt, counted from its own compare periods, for getMicros().
+// Costs a few us in each timer ISR
+#ifndef TIMER_INTERRUPT_TIME_BASE
+  #define TIMER_INTERRUPT_TIME_BASE  false
+#endif
+
+// Estimated CPU cycles of one timer ISR, callback excluded, for the ISR load of printTimerReport()
+#ifndef TIMER_INTERRUPT_ISR_CYCLES
+  #define TIMER_INTERRUPT_ISR_CYCLES 120
+#endif
+
 #include "TimerInterrupt_Generic_Debug.h"
 
 #ifndef TIMER_INTERRUPT_VERSION
@@ -148,8 +159,8 @@
   #define TIMSK1 TIMSK
 #endif
 
-typedef void (*timer_callback)();
-typedef void (*timer_callback_p)(void *);
+// timer_callback, timer_callback_p and TimerDelegate
+#include "TimerDelegate.hpp"
 
 enum
 {
@@ -189,6 +200,41 @@ enum
 const unsigned int prescalerDiv   [NUM_ITEMS]     = { 1, 1, 8, 64, 256, 1024 };
 const unsigned int prescalerDivT2 [T2_NUM_ITEMS]  = { 1, 1, 8, 32,  64,  128, 256, 1024 };
 
+#if TIMER_INTERRUPT_USING_ATMEGA_32U4
+// CS43:0 of the 10-bit Timer4 of ATmega32U4, division 2^(index - 1)
+enum
+{
+  T4_NO_CLOCK_SOURCE = 0,
+  T4_NO_PRESCALER,
+  T4_PRESCALER_2,
+  T4_PRESCALER_4,
+  T4_PRESCALER_8,
+  T4_PRESCALER_16,
+  T4_PRESCALER_32,
+  T4_PRESCALER_64,
+  T4_PRESCALER_128,
+  T4_PRESCALER_256,
+  T4_PRESCALER_512,
+  T4_PRESCALER_1024,
+  T4_PRESCALER_2048,
+  T4_PRESCALER_4096,
+  T4_PRESCALER_8192,
+  T4_PRESCALER_16384,
+  T4_NUM_ITEMS
+};
+
+// Clock sources of Timer4 of ATmega32U4, see TimerInterrupt::setTimer4Clock()
+enum
+{
+  TIMER4_CLOCK_CPU = 0,
+  TIMER4_CLOCK_PLL_48MHZ,
+  TIMER4_CLOCK_PLL_64MHZ
+};
+#endif
+
+// TimerRegisters<TimerNo>, used by the ISRs
+#include "TimerRegisters.hpp"
+
 class TimerInterrupt
 {
   private:
@@ -197,52 +243,242 @@ class TimerInterrupt
     int8_t          _timer;
     unsigned int    _prescalerIndex;
     uint32_t        _OCRValue;
-    uint32_t        _OCRValueRemaining;
+    uint32_t        _OCRValueRemaining;   // counts left in the period, after the loaded compare
+    uint32_t        _numChunks;           // compares per period
+    uint32_t        _chunkCounts;         // counts of the short compares, the long ones have 1 more
+    uint32_t        _shortChunksCounts;   // counts of all the short compares, loaded last
+    uint8_t         _planPolicy;
+    uint16_t        _maxErrorPpm;
+    bool            _isDitheringAllowed;  // see setDithering()
+    uint16_t        _maxJitterCycles;
+    uint32_t        _ditherStep;          // fraction of a count added per period, in 1 / 2^32. 0 => not dithering
+    uint32_t        _ditherPhase;
+    uint32_t        _pendingOCRValue;     // period of setPeriodAsync(), applied by the ISR at the end of the running one
+    uint8_t         _pendingPrescalerIndex;
+    uint32_t        _pendingFrequencyNum;
+    uint32_t        _pendingFrequencyDen;
+    volatile bool   _isPeriodPending;
     volatile long   _toggle_count;
-    double           _frequency;
+    uint32_t        _frequencyNum;    // frequency is _frequencyNum / _frequencyDen Hz
+    uint32_t        _frequencyDen;
+#if TIMER_INTERRUPT_USING_ATMEGA_32U4
+    uint32_t        _timerClock;      // Hz of the clock before the prescaler, F_CPU or the PLL for Timer4
+#endif
+
+    TimerDelegate   _callback;        // callback function, and its parameter if any
 
-    void*           _callback;        // pointer to the callback function
-    void*           _params;          // function parameter
+#if TIMER_INTERRUPT_TIME_BASE
+    volatile uint32_t _elapsedMicros;   // us of the ended compare periods
+    volatile uint8_t  _elapsedCycles;   // and the remaining CPU cycles, less than 1us
+    volatile uint16_t _currentOCR;      // OCR of the running compare period
+
+    void addElapsedCycles(uint32_t cycles) __attribute__((always_inline))
+    {
+      cycles += _elapsedCycles;
+
+      _elapsedMicros += cycles / clockCyclesPerMicrosecond();
+      _elapsedCycles  = cycles % clockCyclesPerMicrosecond();
+    }
+#endif
 
     void set_OCR();
 
+    // Same as set_OCR(), with the registers of TimerNo bound at compile time
+    template<uint8_t TimerNo>
+    __attribute__((always_inline)) void set_OCR()
+    {
+      // Counts of the next compare. See planChunks()
+      uint32_t countsToUse    = (_OCRValueRemaining > _shortChunksCounts) ? _chunkCounts + 1 : _chunkCounts;
+      uint16_t OCRValueToUse  = countsToUse - 1;
+
+      TimerRegisters<TimerNo>::setOCR(OCRValueToUse);
+      _OCRValueRemaining -= countsToUse;
+
+#if TIMER_INTERRUPT_TIME_BASE
+      _currentOCR = OCRValueToUse;
+#endif
+
+      TimerRegisters<TimerNo>::enableInterrupt();
+
+      // Flag _OCRValue == 0 => end of long timer
+      if (_OCRValueRemaining == 0)
+        _timerDone = true;
+    }
+
+    // CSx2:0 bits of the timer, 0 => no clock source
+    void setPrescaler(uint8_t prescalerIndex);
+
+    void setNextCycles(uint32_t cycles);
+
+    // setNextInterval(0)
+    void stopNextInterval();
+
+    bool planFrequency(uint32_t num, uint32_t den, uint8_t& prescalerIndex, uint32_t& OCRValue, bool singleCompare = false);
+
+    // Period of num / den hertz in counts of prescalerIndex: whole counts, returned, and the fraction of a count
+    // left, in 1 / 2^32. 0xFFFFFFFF if longer
+    uint32_t periodCounts(uint32_t num, uint32_t den, uint8_t prescalerIndex, uint32_t& fraction);
+
+    // Same as periodCounts(), rounded to the nearest count
+    uint32_t roundedCounts(uint32_t num, uint32_t den, uint8_t prescalerIndex)
+    {
+      uint32_t fraction;
+      uint32_t counts = periodCounts(num, den, prescalerIndex, fraction);
+
+      return ( (fraction >= 0x80000000UL) && (counts < 0xFFFFFFFFUL) ) ? counts + 1 : counts;
+    }
+
+    // Number of periods of num / den hertz in duration (in milliseconds), for _toggle_count
+    static uint32_t countPeriods(uint32_t num, uint32_t den, unsigned long duration);
+
+    // Buffer the next period for apply_Period(). frequency is num / den hertz for getErrorPpm(), num = 0 => none
+    bool queuePeriod(uint8_t prescalerIndex, uint32_t OCRValue, uint32_t num, uint32_t den);
+
+    void planChunks();
+
+    // Counter max of the timer, 8, 10 or 16-bit
+    uint32_t getMaxCount() __attribute__((always_inline))
+    {
+#if TIMER_INTERRUPT_USING_ATMEGA_32U4
+      return (_timer == 4) ? MAX_COUNT_10BIT : MAX_COUNT_16BIT;
+#else
+      return (_timer == 2) ? MAX_COUNT_8BIT : MAX_COUNT_16BIT;
+#endif
+    }
+
+    // Largest prescaler index. The smallest one is always NO_PRESCALER, T2_NO_PRESCALER or T4_NO_PRESCALER, 1
+    uint8_t getLastPrescalerIndex() __attribute__((always_inline))
+    {
+#if TIMER_INTERRUPT_USING_ATMEGA_32U4
+      if (_timer == 4)
+        return T4_PRESCALER_16384;
+#endif
+
+      return (_timer == 2) ? (uint8_t) T2_PRESCALER_1024 : (uint8_t) PRESCALER_1024;
+    }
+
+    void planDithering(uint32_t num, uint32_t den);
+
+    // frequency (in hertz) as num / den, in uHz below 1kHz, in mHz below 4MHz, in Hz above
+    static bool toRatio(float frequency, uint32_t& num, uint32_t& den)
+    {
+      if ( (frequency <= 0) || (frequency >= 4.0E9f) )
+        return false;
+
+      if (frequency < 1000.0f)
+      {
+        num = (uint32_t) (frequency * 1000000.0f + 0.5f);
+        den = 1000000UL;
+      }
+      else if (frequency < 4000000.0f)
+      {
+        num = (uint32_t) (frequency * 1000.0f + 0.5f);
+        den = 1000UL;
+      }
+      else
+      {
+        num = (uint32_t) (frequency + 0.5f);
+        den = 1;
+      }
+
+      return true;
+    }
+
+    // Toggle output of pinTimer, without any interrupt. Returns false if pinTimer isn't on TimerNo
+    template<uint8_t TimerNo>
+    bool startOutput(uint8_t pinTimer, uint8_t prescalerIndex, uint16_t OCRValue)
+    {
+      if (!TimerRegisters<TimerNo>::setToggleOutput(pinTimer))
+        return false;
+
+      TimerRegisters<TimerNo>::disableInterrupt();
+      TimerRegisters<TimerNo>::setOCR(OCRValue);
+      TimerRegisters<TimerNo>::resetCount();
+      TimerRegisters<TimerNo>::setPrescaler(prescalerIndex);
+
+      return true;
+    }
+
   public:
 
+    // setPlanPolicy() policies
+    const static uint8_t PLAN_ACCURACY        = 0;
+    const static uint8_t PLAN_FEWEST_WAKEUPS  = 1;
+
     TimerInterrupt()
     {
       _timer              = -1;
-      _frequency          = 0;
-      _callback           = NULL;
-      _params             = NULL;
+      _frequencyNum       = 0;
+      _frequencyDen       = 1;
+#if TIMER_INTERRUPT_USING_ATMEGA_32U4
+      _timerClock         = F_CPU;
+#endif
+      _callback           = TimerDelegate();
       _timerDone          = false;
       _prescalerIndex     = NO_PRESCALER;
       _OCRValue           = 0;
       _OCRValueRemaining  = 0;
+      _numChunks          = 1;
+      _chunkCounts        = 1;
+      _isDitheringAllowed = false;
+      _maxJitterCycles    = 0;
+      _ditherStep         = 0;
+      _ditherPhase        = 0;
+      _pendingOCRValue    = 0;
+      _pendingPrescalerIndex = NO_PRESCALER;
+      _pendingFrequencyNum = 0;
+      _pendingFrequencyDen = 1;
+      _isPeriodPending    = false;
+      _shortChunksCounts  = 1;
+      _planPolicy         = PLAN_ACCURACY;
+      _maxErrorPpm        = 0;
       _toggle_count       = -1;
+#if TIMER_INTERRUPT_TIME_BASE
+      _elapsedMicros      = 0;
+      _elapsedCycles      = 0;
+      _currentOCR         = 0;
+#endif
     };
 
     explicit TimerInterrupt(uint8_t timerNo)
     {
       _timer              = timerNo;
-      _frequency          = 0;
-      _callback           = NULL;
-      _params             = NULL;
+      _frequencyNum       = 0;
+      _frequencyDen       = 1;
+#if TIMER_INTERRUPT_USING_ATMEGA_32U4
+      _timerClock         = F_CPU;
+#endif
+      _callback           = TimerDelegate();
       _timerDone          = false;
       _prescalerIndex     = NO_PRESCALER;
       _OCRValue           = 0;
       _OCRValueRemaining  = 0;
+      _numChunks          = 1;
+      _chunkCounts        = 1;
+      _isDitheringAllowed = false;
+      _maxJitterCycles    = 0;
+      _ditherStep         = 0;
+      _ditherPhase        = 0;
+      _pendingOCRValue    = 0;
+      _pendingPrescalerIndex = NO_PRESCALER;
+      _pendingFrequencyNum = 0;
+      _pendingFrequencyDen = 1;
+      _isPeriodPending    = false;
+      _shortChunksCounts  = 1;
+      _planPolicy         = PLAN_ACCURACY;
+      _maxErrorPpm        = 0;
       _toggle_count       = -1;
+#if TIMER_INTERRUPT_TIME_BASE
+      _elapsedMicros      = 0;
+      _elapsedCycles      = 0;
+      _currentOCR         = 0;
+#endif
     };
 
+    // Single indirect call. Calls nothing if no callback
     void callback() __attribute__((always_inline))
     {
-      if (_callback != NULL)
-      {
-        if (_params != NULL)
-          (*(timer_callback_p)_callback)(_params);
-        else
-          (*(timer_callback)_callback)();
-      }
+      _callback();
     }
 
     void init(int8_t timer);
@@ -252,54 +488,294 @@ class TimerInterrupt
       init(_timer);
     };
 
-    // frequency (in hertz) and duration (in milliseconds). Duration = 0 or not specified => run indefinitely
-    bool setFrequency(float frequency, timer_callback_p callback, /* void* */ uint32_t params, unsigned long duration = 0);
+    // frequency of num / den hertz, such as (1000, interval) for interval in ms, and duration (in milliseconds).
+    // Duration = 0 or not specified => run indefinitely. Integer math only, with the most accurate prescaler
+    bool setFrequency(uint32_t num, uint32_t den, const TimerDelegate& callback, unsigned long duration = 0);
+
+    // frequency (in hertz) and duration (in milliseconds). Duration = 0 or not specified => run indefinitely.
+    // frequency is converted once to a num / den ratio, see toRatio(), then planned with integer math
+    bool setFrequency(float frequency, const TimerDelegate& callback, unsigned long duration = 0)
+    {
+      uint32_t num, den;
+
+      return toRatio(frequency, num, den) && setFrequency(num, den, callback, duration);
+    }
+
+    // frequency (in hertz) and duration (in milliseconds). Duration = 0 or not specified => run indefinitely.
+    // params = 0 => callback is called without parameter
+    bool setFrequency(float frequency, timer_callback_p callback, /* void* */ uint32_t params, unsigned long duration = 0)
+    {
+      return setFrequency(frequency, params ? TimerDelegate(callback, reinterpret_cast<void*>(params)) :
+                                              TimerDelegate(reinterpret_cast<timer_callback>(callback)), duration);
+    }
 
     // frequency (in hertz) and duration (in milliseconds). Duration = 0 or not specified => run indefinitely
     bool setFrequency(float frequency, timer_callback callback, unsigned long duration = 0)
     {
-      return setFrequency(frequency, reinterpret_cast<timer_callback_p>(callback), /*NULL*/ 0, duration);
+      return setFrequency(frequency, TimerDelegate(callback), duration);
     }
 
-    // interval (in ms) and duration (in milliseconds). Duration = 0 or not specified => run indefinitely
+    // interval (in ms) and duration (in milliseconds). Duration = 0 or not specified => run indefinitely.
+    // params is copied into the TimerDelegate, up to TIMER_DELEGATE_CONTEXT_SIZE bytes
     template<typename TArg>
     bool setInterval(unsigned long interval, void (*callback)(TArg), TArg params, unsigned long duration = 0)
     {
-      static_assert(sizeof(TArg) <= sizeof(uint32_t), "setInterval() callback argument size must be <= 4 bytes");
-      return setFrequency((float) (1000.0f / interval), reinterpret_cast<timer_callback_p>(callback), (uint32_t) params, duration);
+      return setFrequency(1000UL, interval, TimerDelegate(callback, params), duration);
+    }
+
+    // interval (in ms) and duration (in milliseconds). Duration = 0 or not specified => run indefinitely
+    bool setInterval(unsigned long interval, const TimerDelegate& callback, unsigned long duration = 0)
+    {
+      return setFrequency(1000UL, interval, callback, duration);
     }
 
     // interval (in ms) and duration (in milliseconds). Duration = 0 or not specified => run indefinitely
     bool setInterval(unsigned long interval, timer_callback callback, unsigned long duration = 0)
     {
-      return setFrequency((float) (1000.0f / interval), reinterpret_cast<timer_callback_p>(callback), /*NULL*/ 0, duration);
+      return setFrequency(1000UL, interval, TimerDelegate(callback), duration);
+    }
+
+    // interval (in us) and duration (in milliseconds). Duration = 0 or not specified => run indefinitely
+    bool setIntervalMicros(unsigned long interval, const TimerDelegate& callback, unsigned long duration = 0)
+    {
+      return setFrequency(1000000UL, interval, callback, duration);
     }
 
+    // params is copied into the TimerDelegate, up to TIMER_DELEGATE_CONTEXT_SIZE bytes
     template<typename TArg>
     bool attachInterrupt(float frequency, void (*callback)(TArg), TArg params, unsigned long duration = 0)
     {
-      static_assert(sizeof(TArg) <= sizeof(uint32_t), "attachInterrupt() callback argument size must be <= 4 bytes");
-      return setFrequency(frequency, reinterpret_cast<timer_callback_p>(callback), (uint32_t) params, duration);
+      return setFrequency(frequency, TimerDelegate(callback, params), duration);
+    }
+
+    // such as TimerDelegate(&object, &Class::method)
+    bool attachInterrupt(float frequency, const TimerDelegate& callback, unsigned long duration = 0)
+    {
+      return setFrequency(frequency, callback, duration);
     }
 
     bool attachInterrupt(float frequency, timer_callback callback, unsigned long duration = 0)
     {
-      return setFrequency(frequency, reinterpret_cast<timer_callback_p>(callback), /*NULL*/ 0, duration);
+      return setFrequency(frequency, TimerDelegate(callback), duration);
     }
 
     // Interval (in ms) and duration (in milliseconds). Duration = 0 or not specified => run indefinitely
+    // params is copied into the TimerDelegate, up to TIMER_DELEGATE_CONTEXT_SIZE bytes
     template<typename TArg>
     bool attachInterruptInterval(unsigned long interval, void (*callback)(TArg), TArg params, unsigned long duration = 0)
     {
-      static_assert(sizeof(TArg) <= sizeof(uint32_t), "attachInterruptInterval() callback argument size must be <= 4 bytes");
-      return setFrequency( (float) ( 1000.0f / interval), reinterpret_cast<timer_callback_p>(callback), (uint32_t) params, duration);
+      return setFrequency(1000UL, interval, TimerDelegate(callback, params), duration);
+    }
+
+    // Interval (in ms) and duration (in milliseconds). Duration = 0 or not specified => run indefinitely
+    bool attachInterruptInterval(unsigned long interval, const TimerDelegate& callback, unsigned long duration = 0)
+    {
+      return setFrequency(1000UL, interval, callback, duration);
     }
 
     // Interval (in ms) and duration (in milliseconds). Duration = 0 or not specified => run indefinitely
     bool attachInterruptInterval(unsigned long interval, timer_callback callback, unsigned long duration = 0)
     {
-      return setFrequency( (float) ( 1000.0f / interval), reinterpret_cast<timer_callback_p> (callback), /*NULL*/ 0, duration);
+      return setFrequency(1000UL, interval, TimerDelegate(callback), duration);
+    }
+
+    // Prescaler choice of the next setFrequency(), attachInterrupt(), setInterval(), etc.
+    // PLAN_ACCURACY (default) : the smallest error, even if long periods are chained through many compares.
+    // PLAN_FEWEST_WAKEUPS : the largest prescaler within maxErrorPpm of the period, so the fewest compare interrupts
+    void setPlanPolicy(uint8_t policy, uint16_t maxErrorPpm = 100)
+    {
+      _planPolicy   = policy;
+      _maxErrorPpm  = maxErrorPpm;
+    }
+
+    // Fractional mode of the next setFrequency(), attachInterrupt(), setInterval(), etc.
+    // When the period isn't a whole number of counts, the ISR alternates OCR and OCR + 1 with a phase accumulator, so
+    // that the average frequency is the requested one within 1ppm. Each period then jitters by one count, so only the
+    // prescalers of at most maxJitterCycles CPU cycles are used, the smallest fitting one compare. Off by default
+    void setDithering(bool enable, uint16_t maxJitterCycles = 8)
+    {
+      _isDitheringAllowed = enable;
+      _maxJitterCycles    = maxJitterCycles;
+    }
+
+    // true if the running period is dithered
+    bool isDithering() __attribute__((always_inline))
+    {
+      return (_ditherStep != 0);
+    }
+
+    // Compare interrupts per period, the last one calling the callback. Long periods are split into equal compares
+    uint32_t getWakeupsPerPeriod() __attribute__((always_inline))
+    {
+      return _numChunks;
+    }
+
+    // Division of prescalerIndex of this timer
+    unsigned int getPrescalerDiv(uint8_t prescalerIndex) __attribute__((always_inline))
+    {
+#if TIMER_INTERRUPT_USING_ATMEGA_32U4
+      if (_timer == 4)
+        return (prescalerIndex == T4_NO_CLOCK_SOURCE) ? 1 : 1U << (prescalerIndex - 1);
+#endif
+
+      return (_timer == 2) ? prescalerDivT2[prescalerIndex] : prescalerDiv[prescalerIndex];
+    }
+
+    // Division of the running prescaler
+    unsigned int getPrescalerDiv() __attribute__((always_inline))
+    {
+      return getPrescalerDiv(_prescalerIndex);
+    }
+
+    // Hz of the timer clock, before the prescaler
+    uint32_t getTimerClock() __attribute__((always_inline))
+    {
+#if TIMER_INTERRUPT_USING_ATMEGA_32U4
+      return _timerClock;
+#else
+      return F_CPU;
+#endif
+    }
+
+#if TIMER_INTERRUPT_USING_ATMEGA_32U4
+    // Clock of Timer4, TIMER4_CLOCK_CPU (default), TIMER4_CLOCK_PLL_48MHZ or TIMER4_CLOCK_PLL_64MHZ, for a finer
+    // resolution at high frequencies, used by the next setFrequency(), attachInterrupt(), etc.
+    // TIMER4_CLOCK_PLL_64MHZ runs the PLL at 96MHz, USB staying at 48MHz with PLLUSB, and waits for the PLL to lock
+    // again, with interrupts off: call it early in setup(). As the relock stops the clock of USB, it's refused while
+    // USB is enabled, as on Leonardo / Micro with USB Serial, unless the PLL is already at 96MHz. Returns false then,
+    // if not Timer4, or with TIMER_INTERRUPT_TIME_BASE, in CPU cycles
+    bool setTimer4Clock(uint8_t clockSource);
+#endif
+
+    // floor(a * b / c), and its remainder, with 32-bit math only: no 64-bit division, a large library function on AVR.
+    // 0xFFFFFFFF if the quotient doesn't fit in 32 bits
+    static uint32_t mulDiv(uint32_t a, uint32_t b, uint32_t c, uint32_t& remainder);
+
+    // floor(a * b / c), see mulDiv(a, b, c, remainder)
+    static uint32_t mulDiv(uint32_t a, uint32_t b, uint32_t c)
+    {
+      uint32_t remainder;
+
+      return mulDiv(a, b, c, remainder);
+    }
+
+    // floor(remainder * 2^32 / c), the fraction of remainder < c in 1 / 2^32
+    static uint32_t fraction32(uint32_t remainder, uint32_t c);
+
+    // Timer counts, after the prescaler, per period
+    uint32_t getPeriodTicks() __attribute__((always_inline))
+    {
+      return _OCRValue + 1;
+    }
+
+    // Actual frequency (in hertz), after the prescaler and OCR quantization. Averaged over the periods if dithering
+    float getActualFrequency()
+    {
+      return (float) getTimerClock() / ( ((float) getPeriodTicks() + _ditherStep / 4294967296.0f) * getPrescalerDiv() );
+    }
+
+    // Error (in ppm) of the actual period vs. the one of the last setFrequency(), attachInterrupt(), etc.
+    // > 0 => the actual period is longer, and the actual frequency lower
+    long getErrorPpm();
+
+    // true if the compare interrupt is enabled
+    bool isEnabled();
+
+    // Prescaler, OCR, actual frequency, error, wake-ups per period and estimated ISR CPU load, on one line
+    void printReport(Print& out);
+
+    // Square wave of num / den hertz on pin, toggled by the timer hardware on each compare, without any interrupt.
+    // pin must be an OCxA, OCxB or OCxC output of this timer, see digitalPinToTimer(). Up to F_CPU / 2.
+    // The compare interrupt is disabled, and getActualFrequency() is the compare rate, twice the output frequency
+    bool attachOutput(uint32_t num, uint32_t den, uint8_t pin);
+
+    // Square wave of frequency (in hertz) on pin, see attachOutput(num, den, pin)
+    bool attachOutput(float frequency, uint8_t pin)
+    {
+      uint32_t num, den;
+
+      return toRatio(frequency, num, den) && attachOutput(num, den, pin);
+    }
+
+    // Disconnect the output pins of this timer, back to normal port operation. The timer keeps counting
+    void detachOutput();
+
+    // Change the period to periodMicros (in us) at the end of the running one, applied by the ISR, so that no period
+    // is cut or doubled, as it can be by setFrequency() when the count is already past the new OCR. The running
+    // prescaler is kept, with O(1) integer math, if it's still the smallest one fitting one compare, or if both periods
+    // need several compares. Otherwise the period is planned again, and the new prescaler may shift the phase by up to
+    // one count. Not dithered. Returns false if out of range, or shorter than TIMER_INTERRUPT_ISR_CYCLES CPU cycles
+    bool setPeriodAsync(unsigned long periodMicros);
+
+    // Same as setPeriodAsync(), with periodTicks timer counts of the running prescaler, see getPeriodTicks(). Their
+    // frequency is kept for getErrorPpm() and reattachInterrupt(duration)
+    bool setPeriodTicksAsync(uint32_t periodTicks);
+
+    // true until the ISR applies the last setPeriodAsync() or setPeriodTicksAsync()
+    bool isPeriodPending() __attribute__((always_inline))
+    {
+      return _isPeriodPending;
+    }
+
+    // Called at the start of the ISR of TimerNo, if isPeriodPending(). At the end of a period, switch to the new one
+    // while the counter, just restarted from 0, is still before its first compare
+    template<uint8_t TimerNo>
+    __attribute__((always_inline)) void apply_Period()
+    {
+      // Intermediate compare of a long period
+      if (!_timerDone)
+        return;
+
+      if (_prescalerIndex != _pendingPrescalerIndex)
+      {
+        _prescalerIndex = _pendingPrescalerIndex;
+        TimerRegisters<TimerNo>::setPrescaler(_prescalerIndex);
+      }
+
+      _OCRValue         = _pendingOCRValue;
+      _frequencyNum     = _pendingFrequencyNum;
+      _frequencyDen     = _pendingFrequencyDen;
+      _ditherStep       = 0;
+      _isPeriodPending  = false;
+
+      if (_OCRValue <= TimerRegisters<TimerNo>::MAX_COUNT)
+      {
+        // One compare, as planChunks() without its divisions. Loaded now, _timerDone stays true for the callback
+        _numChunks          = 1;
+        _chunkCounts        = _OCRValue + 1;
+        _shortChunksCounts  = _chunkCounts;
+        _OCRValueRemaining  = _chunkCounts;
+
+        set_OCR<TimerNo>();
+      }
+      else
+      {
+        // Several compares, the first one loaded by reload_OCRValue() after the callback
+        planChunks();
+      }
+    }
+
+    // Tickless mode, see ISR_Timer::setTickless(). Restart the count and interrupt once after interval (in ms),
+    // with the smallest prescaler fitting the interval in one compare. interval = 0 => stop interrupts until next call.
+    // With TIMER_INTERRUPT_TIME_BASE, getMicros() must keep counting, so interval = 0 only stops the callback for
+    // about 2^32 CPU cycles (268s at 16MHz), and the timer still interrupts at the end of each full compare period
+    void setNextInterval(unsigned long interval);
+
+    // Same as setNextInterval(), with interval in us, up to 65535000us
+    void setNextIntervalMicros(unsigned long interval);
+
+#if TIMER_INTERRUPT_TIME_BASE
+    // Time (in us) since this timer was first started, with the resolution of its prescaler.
+    // Drop-in for micros() as ISR_TimerN time base, and still valid with interrupts disabled for up to one compare period
+    unsigned long getMicros();
+
+    // Called at the start of the ISR of TimerNo, to count the ended compare period
+    template<uint8_t TimerNo>
+    __attribute__((always_inline)) void updateTimeBase()
+    {
+      addElapsedCycles((uint32_t) (_currentOCR + 1) * TimerRegisters<TimerNo>::getPrescalerDiv(_prescalerIndex));
     }
+#endif
 
     void detachInterrupt();
 
@@ -323,6 +799,10 @@ class TimerInterrupt
     // Just reconnect clock source, continue from the current count
     void resumeTimer();
 
+    // Restart the period as if phaseCounts counts (less than the period) were still to come before the callback,
+    // presetting the counter, with the clock stopped by pauseTimer(). Used by TimerGroup to start timers in phase
+    void restartPeriod(uint32_t phaseCounts);
+
     // Just stop clock source, clear the count
     void stopTimer()
     {
@@ -366,80 +846,58 @@ class TimerInterrupt
       return _OCRValueRemaining;
     };
 
-    void adjust_OCRValue() //__attribute__((always_inline))
+    void adjust_OCRValue();
+
+    // Same as adjust_OCRValue(), for the ISR of TimerNo, without any switch on _timer
+    template<uint8_t TimerNo>
+    __attribute__((always_inline)) void adjust_OCRValue()
     {
       //cli();//stop interrupts
       noInterrupts();
 
-      if (_timer != 2)
-      {
-#if TIMER_INTERRUPT_USING_ATMEGA_32U4
-        if (_timer == 4)
-        {
-          if (_OCRValueRemaining < MAX_COUNT_8BIT)
-          {
-            set_OCR();
-          }
-          
-          _OCRValueRemaining -= min(MAX_COUNT_8BIT, _OCRValueRemaining);
-        }
-        else
-        {
-          if (_OCRValueRemaining < MAX_COUNT_16BIT)
-          {
-            set_OCR();
-          }
-        
-          _OCRValueRemaining -= min(MAX_COUNT_16BIT, _OCRValueRemaining);
-        }
-#else
-        if (_OCRValueRemaining < MAX_COUNT_16BIT)
-        {
-          set_OCR();
-        }
-          
-        _OCRValueRemaining -= min(MAX_COUNT_16BIT, _OCRValueRemaining);
-#endif      
-      }
-      else
-      {
-        if (_OCRValueRemaining < MAX_COUNT_8BIT)
-        {
-          set_OCR();
-        }
-          
-        _OCRValueRemaining -= min(MAX_COUNT_8BIT, _OCRValueRemaining);
-      }
-
-      if (_OCRValueRemaining <= 0)
-      {
-        // Reset value for next cycle
-        _OCRValueRemaining = _OCRValue;
-        _timerDone = true;
-      }
-      else
-        _timerDone = false;
+      // Load the next compare. Flag _timerDone if it's the last one
+      set_OCR<TimerNo>();
 
       //sei();//enable interrupts
       interrupts();
     };
 
-    void reload_OCRValue() //__attribute__((always_inline))
+    void reload_OCRValue();
+
+    // Same as reload_OCRValue(), for the ISR of TimerNo, without any switch on _timer
+    template<uint8_t TimerNo>
+    __attribute__((always_inline)) void reload_OCRValue()
     {
       //cli();//stop interrupts
       noInterrupts();
 
-      // Reset value for next cycle, have to deduct the value already loaded to OCR register
-      
-      _OCRValueRemaining = _OCRValue;
-      set_OCR();
-
+      // Reset value for next cycle, and load its first compare
+      _OCRValueRemaining = _OCRValue + 1;
       _timerDone = false;
 
+      set_OCR<TimerNo>();
+
       //sei();//enable interrupts
       interrupts();
     };
 
+    // Called at the start of each period of a dithered timer, before the callback, so that OCR is set well before
+    // the compare: 1 more count on each carry of the phase
+    template<uint8_t TimerNo>
+    __attribute__((always_inline)) void dither_OCRValue()
+    {
+      uint32_t phase          = _ditherPhase + _ditherStep;
+      uint16_t OCRValueToUse  = _OCRValue + (phase < _ditherPhase);
+
+      _ditherPhase = phase;
+
+      TimerRegisters<TimerNo>::setOCR(OCRValueToUse);
+
+#if TIMER_INTERRUPT_TIME_BASE
+      _currentOCR = OCRValueToUse;
+#endif
+    }
+
     bool checkTimerDone() //__attribute__((always_inline))
     {
       return _timerDone;
@@ -447,6 +905,9 @@ class TimerInterrupt
 
 }; // class TimerInterrupt
 
+// printReport() of every ITimerN enabled by USE_TIMER_N, such as printTimerReport(Serial)
+void printTimerReport(Print& out = Serial);
+
 //////////////////////////////////////////////
 
 // To be sure not used Timers are disabled
@@ -471,7 +932,7 @@ class TimerInterrupt
 #if !defined(USE_TIMER_4)
   #define USE_TIMER_4     false
 #elif ( USE_TIMER_4 && ( TIMER_INTERRUPT_USING_ATMEGA_32U4 || TIMER_INTERRUPT_USING_ATMEGA2560 ) )
-  #warning Timer4 is OK to use for ATMEGA_32U4 (10-bit but using as 8-bit) and Mega (16-bit)
+  #warning Timer4 is OK to use for ATMEGA_32U4 (10-bit) and Mega (16-bit)
 #elif USE_TIMER_4
   #error Timer4 is only available for ATMEGA_32U4 and Mega
 #endif
@@ -0,0 +1,1089 @@
+/****************************************************************************************************************************
+  TimerRegisters.hpp
+  For Arduino boards (UNO, Nano, Mega, etc. )
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt
+  Licensed under MIT license
+
+  TimerRegisters<TimerNo> binds the registers of one hardware timer at compile time, so that the code of each timer ISR
+  touches only its own registers, without any switch on the timer number. StaticTimer, TimerCapture and TimerChannels
+  go through it too.
+  TIMER_REGISTERS_1 .. TIMER_REGISTERS_5 are true for the timers available on the board.
+
+  Version: 1.8.0
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K Hoang      23/11/2019 Initial coding
+  1.0.1   K Hoang      25/11/2019 New release fixing compiler error
+  1.0.2   K.Hoang      28/11/2019 Permit up to 16 super-long-time, super-accurate ISR-based timers to avoid being blocked
+  1.0.3   K.Hoang      01/12/2020 Add complex examples ISR_16_Timers_Array_Complex and ISR_16_Timers_Array_Complex
+  1.1.1   K.Hoang      06/12/2020 Add example Change_Interval. Bump up version to sync with other TimerInterrupt Libraries
+  1.1.2   K.Hoang      05/01/2021 Fix warnings. Optimize examples to reduce memory usage
+  1.2.0   K.Hoang      07/01/2021 Add better debug feature. Optimize code and examples to reduce RAM usage
+  1.3.0   K.Hoang      25/02/2021 Add support to AVR ATMEGA_32U4 such as Leonardo, YUN, ESPLORA, etc.
+  1.4.0   K.Hoang      01/04/2021 Add support to Adafruit 32U4 and 328(P) such as FEATHER32U4, FEATHER328P, etc.
+  1.4.1   K.Hoang      02/04/2021 Add support to Sparkfun 32U4, 328(P), 128RFA1 such as AVR_PROMICRO, REDBOT, etc.
+  1.5.0   K.Hoang      08/05/2021 Add Timer 3 and 4 to 32U4. Add Timer auto-selection to examples.
+  1.6.0   K.Hoang      15/11/2021 Fix bug resulting half frequency when using high frequencies.
+  1.7.0   K.Hoang      19/11/2021 Fix bug resulting wrong frequency for some frequencies.
+  1.8.0   K.Hoang      18/01/2022 Fix `multiple-definitions` linker error
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef TIMER_REGISTERS_HPP
+#define TIMER_REGISTERS_HPP
+
+template<uint8_t TimerNo>
+struct TimerRegisters;
+
+#if defined(OCR1A) && defined(TCCR1B)
+
+#define TIMER_REGISTERS_1     true
+
+template<>
+struct TimerRegisters<1>
+{
+  enum { MAX_COUNT = MAX_COUNT_16BIT };
+
+  static void setOCR(uint16_t value) __attribute__((always_inline))
+  {
+    OCR1A = value;
+  }
+
+  // Bit 1 – OCIEA: Output Compare A Match Interrupt Enable
+  // When this bit is written to '1', and the I-flag in the Status Register is set (interrupts globally enabled), the
+  // Timer/Counter Output Compare A Match interrupt is enabled. The corresponding Interrupt Vector is
+  // executed when the OCFA Flag, located in TIFR1, is set.
+  static void enableInterrupt() __attribute__((always_inline))
+  {
+#if defined(TIMSK1) && defined(OCIE1A)
+    bitWrite(TIMSK1, OCIE1A, 1);
+#elif defined(TIMSK) && defined(OCIE1A)
+    // this combination is for at least the ATmega32
+    bitWrite(TIMSK, OCIE1A, 1);
+#endif
+  }
+
+  static void disableInterrupt() __attribute__((always_inline))
+  {
+#if defined(TIMSK1) && defined(OCIE1A)
+    bitWrite(TIMSK1, OCIE1A, 0);
+#elif defined(TIMSK) && defined(OCIE1A)
+    bitWrite(TIMSK, OCIE1A, 0);
+#endif
+  }
+
+  static bool isInterruptEnabled() __attribute__((always_inline))
+  {
+#if defined(TIMSK1) && defined(OCIE1A)
+    return bitRead(TIMSK1, OCIE1A);
+#elif defined(TIMSK) && defined(OCIE1A)
+    return bitRead(TIMSK, OCIE1A);
+#else
+    return false;
+#endif
+  }
+
+  // CSx2:0 bits, 0 => no clock source
+  static void setPrescaler(uint8_t prescalerIndex) __attribute__((always_inline))
+  {
+    TCCR1B = (TCCR1B & 0b11111000) | prescalerIndex;
+  }
+
+  static uint16_t getPrescalerDiv(uint8_t prescalerIndex) __attribute__((always_inline))
+  {
+    return prescalerDiv[prescalerIndex];
+  }
+
+  static void resetCount() __attribute__((always_inline))
+  {
+    TCNT1 = 0;
+  }
+
+  static uint16_t getCount() __attribute__((always_inline))
+  {
+    return TCNT1;
+  }
+
+  static void setCount(uint16_t count) __attribute__((always_inline))
+  {
+    TCNT1 = count;
+  }
+
+  // Clear a pending compare A interrupt, by writing 1
+  static void clearInterruptFlag() __attribute__((always_inline))
+  {
+#if defined(TIFR1) && defined(OCF1A)
+    TIFR1 = _BV(OCF1A);
+#endif
+  }
+
+  // Compare A flag still set => its interrupt hasn't run yet
+  static bool isInterruptPending() __attribute__((always_inline))
+  {
+#if defined(TIFR1) && defined(OCF1A)
+    return bitRead(TIFR1, OCF1A);
+#else
+    return false;
+#endif
+  }
+
+#if defined(WGM12)
+  // CTC mode, from 0 to OCR1A = OCRValue, with prescalerIndex and the compare A interrupt. The clock is stopped
+  // and any stale compare flag cleared first, see StaticTimer
+  static void startCTC(uint8_t prescalerIndex, uint16_t OCRValue)
+  {
+    TCCR1A = 0;
+    TCCR1B = 0;
+    TCNT1  = 0;
+    OCR1A  = OCRValue;
+    clearInterruptFlag();
+    enableInterrupt();
+    TCCR1B = _BV(WGM12) | prescalerIndex;
+  }
+#endif
+
+#if defined(ICR1) && defined(TIMSK1) && defined(ICIE1)
+  // Counter latched by the last edge on ICP1, see TimerCapture
+  static uint16_t getCapture() __attribute__((always_inline))
+  {
+    return ICR1;
+  }
+
+  // Overflow flag still set => the overflow interrupt hasn't run yet
+  static bool isOverflowPending() __attribute__((always_inline))
+  {
+    return bitRead(TIFR1, TOV1);
+  }
+
+  // Normal mode, from 0 to 0xFFFF with prescalerIndex, capturing the rising or falling edges of ICP1, with the
+  // capture and overflow interrupts instead of the compare A one. The clock is stopped and any stale flag cleared first
+  static void startCapture(uint8_t prescalerIndex, bool isRising, bool noiseCanceler)
+  {
+    TCCR1A = 0;
+    TCCR1B = 0;
+    TCNT1  = 0;
+    TIFR1  = _BV(ICF1) | _BV(TOV1);
+    TIMSK1 = (TIMSK1 & ~_BV(OCIE1A)) | _BV(ICIE1) | _BV(TOIE1);
+    TCCR1B = prescalerIndex | (isRising ? _BV(ICES1) : 0) | (noiseCanceler ? _BV(ICNC1) : 0);
+  }
+
+  // Disable the capture and overflow interrupts, the counter keeps running
+  static void stopCapture() __attribute__((always_inline))
+  {
+    TIMSK1 &= ~(_BV(ICIE1) | _BV(TOIE1));
+  }
+#endif
+
+#if defined(OCR1B) && defined(TIMSK1) && defined(OCIE1B)
+  // Compare value of channel 0, 1 or 2 => OCR1A, OCR1B or OCR1C, see TimerChannels
+  static uint16_t getCompare(uint8_t channel) __attribute__((always_inline))
+  {
+  #if defined(OCR1C)
+    if (channel == 2)
+      return OCR1C;
+  #endif
+
+    return (channel == 1) ? OCR1B : OCR1A;
+  }
+
+  static void setCompare(uint8_t channel, uint16_t value) __attribute__((always_inline))
+  {
+    if (channel == 0)
+      OCR1A = value;
+    else if (channel == 1)
+      OCR1B = value;
+  #if defined(OCR1C)
+    else
+      OCR1C = value;
+  #endif
+  }
+
+  // Clear a pending compare interrupt of channel, by writing 1, then enable or disable it.
+  // OCIE1x and OCF1x are bits 1, 2 and 3 for A, B and C
+  static void enableCompareInterrupt(uint8_t channel, bool enable) __attribute__((always_inline))
+  {
+    TIFR1 = _BV(OCF1A + channel);
+    bitWrite(TIMSK1, OCIE1A + channel, enable);
+  }
+
+  // Normal mode, free-running from 0 to 0xFFFF with prescalerIndex, without any OC1x pin
+  static void setNormalMode(uint8_t prescalerIndex) __attribute__((always_inline))
+  {
+    TCCR1A = 0;
+    TCCR1B = prescalerIndex;
+  }
+#endif
+
+  // Toggle the OC1x pin of pinTimer, from digitalPinToTimer(), on each compare match with OCR1A in CTC mode.
+  // OC1B and OC1C compare at count 0, to toggle at the same rate. Returns false if pinTimer isn't on Timer1
+  static bool setToggleOutput(uint8_t pinTimer)
+  {
+    switch (pinTimer)
+    {
+#if defined(TIMER1A) && defined(COM1A0)
+
+      case TIMER1A:
+        TCCR1A = (TCCR1A & ~_BV(COM1A1)) | _BV(COM1A0);
+        return true;
+#endif
+
+#if defined(TIMER1B) && defined(COM1B0)
+
+      case TIMER1B:
+        OCR1B = 0;
+        TCCR1A = (TCCR1A & ~_BV(COM1B1)) | _BV(COM1B0);
+        return true;
+#endif
+
+#if defined(TIMER1C) && defined(COM1C0)
+
+      case TIMER1C:
+        OCR1C = 0;
+        TCCR1A = (TCCR1A & ~_BV(COM1C1)) | _BV(COM1C0);
+        return true;
+#endif
+    }
+
+    return false;
+  }
+
+  // Disconnect all the OC1x pins, back to normal port operation
+  static void clearOutputs()
+  {
+#if defined(COM1A0)
+    TCCR1A &= ~(_BV(COM1A1) | _BV(COM1A0));
+#endif
+#if defined(COM1B0)
+    TCCR1A &= ~(_BV(COM1B1) | _BV(COM1B0));
+#endif
+#if defined(COM1C0)
+    TCCR1A &= ~(_BV(COM1C1) | _BV(COM1C0));
+#endif
+  }
+};
+
+#endif
+
+#if defined(OCR2A) && defined(TIMSK2) && defined(OCIE2A) && defined(TCCR2B)
+
+#define TIMER_REGISTERS_2     true
+
+template<>
+struct TimerRegisters<2>
+{
+  enum { MAX_COUNT = MAX_COUNT_8BIT };
+
+  static void setOCR(uint16_t value) __attribute__((always_inline))
+  {
+    OCR2A = value;
+  }
+
+  static void enableInterrupt() __attribute__((always_inline))
+  {
+    bitWrite(TIMSK2, OCIE2A, 1);
+  }
+
+  static void disableInterrupt() __attribute__((always_inline))
+  {
+    bitWrite(TIMSK2, OCIE2A, 0);
+  }
+
+  static bool isInterruptEnabled() __attribute__((always_inline))
+  {
+    return bitRead(TIMSK2, OCIE2A);
+  }
+
+  static void setPrescaler(uint8_t prescalerIndex) __attribute__((always_inline))
+  {
+    TCCR2B = (TCCR2B & 0b11111000) | prescalerIndex;
+  }
+
+  // Timer2 has more prescalers, 1, 8, 32, 64, 128, 256 and 1024
+  static uint16_t getPrescalerDiv(uint8_t prescalerIndex) __attribute__((always_inline))
+  {
+    return prescalerDivT2[prescalerIndex];
+  }
+
+  static void resetCount() __attribute__((always_inline))
+  {
+    TCNT2 = 0;
+  }
+
+  static uint16_t getCount() __attribute__((always_inline))
+  {
+    return TCNT2;
+  }
+
+  static void setCount(uint16_t count) __attribute__((always_inline))
+  {
+    TCNT2 = count;
+  }
+
+  // Clear a pending compare A interrupt, by writing 1
+  static void clearInterruptFlag() __attribute__((always_inline))
+  {
+#if defined(TIFR2) && defined(OCF2A)
+    TIFR2 = _BV(OCF2A);
+#endif
+  }
+
+  // Compare A flag still set => its interrupt hasn't run yet
+  static bool isInterruptPending() __attribute__((always_inline))
+  {
+#if defined(TIFR2) && defined(OCF2A)
+    return bitRead(TIFR2, OCF2A);
+#else
+    return false;
+#endif
+  }
+
+#if defined(WGM21)
+  // CTC mode, from 0 to OCR2A = OCRValue, with prescalerIndex and the compare A interrupt. The clock is stopped
+  // and any stale compare flag cleared first, see StaticTimer
+  static void startCTC(uint8_t prescalerIndex, uint16_t OCRValue)
+  {
+    TCCR2A = _BV(WGM21);
+    TCCR2B = 0;
+    TCNT2  = 0;
+    OCR2A  = OCRValue;
+    clearInterruptFlag();
+    enableInterrupt();
+    TCCR2B = prescalerIndex;
+  }
+#endif
+
+  // Toggle the OC2x pin of pinTimer, from digitalPinToTimer(), on each compare match with OCR2A in CTC mode.
+  // OC2B and OC2C compare at count 0, to toggle at the same rate. Returns false if pinTimer isn't on Timer2
+  static bool setToggleOutput(uint8_t pinTimer)
+  {
+    switch (pinTimer)
+    {
+#if defined(TIMER2A) && defined(COM2A0)
+
+      case TIMER2A:
+        TCCR2A = (TCCR2A & ~_BV(COM2A1)) | _BV(COM2A0);
+        return true;
+#endif
+
+#if defined(TIMER2B) && defined(COM2B0)
+
+      case TIMER2B:
+        OCR2B = 0;
+        TCCR2A = (TCCR2A & ~_BV(COM2B1)) | _BV(COM2B0);
+        return true;
+#endif
+    }
+
+    return false;
+  }
+
+  // Disconnect all the OC2x pins, back to normal port operation
+  static void clearOutputs()
+  {
+#if defined(COM2A0)
+    TCCR2A &= ~(_BV(COM2A1) | _BV(COM2A0));
+#endif
+#if defined(COM2B0)
+    TCCR2A &= ~(_BV(COM2B1) | _BV(COM2B0));
+#endif
+  }
+};
+
+#endif
+
+#if defined(OCR3A) && defined(TIMSK3) && defined(OCIE3A) && defined(TCCR3B)
+
+#define TIMER_REGISTERS_3     true
+
+template<>
+struct TimerRegisters<3>
+{
+  enum { MAX_COUNT = MAX_COUNT_16BIT };
+
+  static void setOCR(uint16_t value) __attribute__((always_inline))
+  {
+    OCR3A = value;
+  }
+
+  static void enableInterrupt() __attribute__((always_inline))
+  {
+    bitWrite(TIMSK3, OCIE3A, 1);
+  }
+
+  static void disableInterrupt() __attribute__((always_inline))
+  {
+    bitWrite(TIMSK3, OCIE3A, 0);
+  }
+
+  static bool isInterruptEnabled() __attribute__((always_inline))
+  {
+    return bitRead(TIMSK3, OCIE3A);
+  }
+
+  static void setPrescaler(uint8_t prescalerIndex) __attribute__((always_inline))
+  {
+    TCCR3B = (TCCR3B & 0b11111000) | prescalerIndex;
+  }
+
+  static uint16_t getPrescalerDiv(uint8_t prescalerIndex) __attribute__((always_inline))
+  {
+    return prescalerDiv[prescalerIndex];
+  }
+
+  static void resetCount() __attribute__((always_inline))
+  {
+    TCNT3 = 0;
+  }
+
+  static uint16_t getCount() __attribute__((always_inline))
+  {
+    return TCNT3;
+  }
+
+  static void setCount(uint16_t count) __attribute__((always_inline))
+  {
+    TCNT3 = count;
+  }
+
+  // Clear a pending compare A interrupt, by writing 1
+  static void clearInterruptFlag() __attribute__((always_inline))
+  {
+    TIFR3 = _BV(OCF3A);
+  }
+
+  // Compare A flag still set => its interrupt hasn't run yet
+  static bool isInterruptPending() __attribute__((always_inline))
+  {
+    return bitRead(TIFR3, OCF3A);
+  }
+
+#if defined(WGM32)
+  // CTC mode, from 0 to OCR3A = OCRValue, with prescalerIndex and the compare A interrupt. The clock is stopped
+  // and any stale compare flag cleared first, see StaticTimer
+  static void startCTC(uint8_t prescalerIndex, uint16_t OCRValue)
+  {
+    TCCR3A = 0;
+    TCCR3B = 0;
+    TCNT3  = 0;
+    OCR3A  = OCRValue;
+    clearInterruptFlag();
+    enableInterrupt();
+    TCCR3B = _BV(WGM32) | prescalerIndex;
+  }
+#endif
+
+#if defined(ICR3) && defined(TIMSK3) && defined(ICIE3)
+  // Counter latched by the last edge on ICP3, see TimerCapture
+  static uint16_t getCapture() __attribute__((always_inline))
+  {
+    return ICR3;
+  }
+
+  // Overflow flag still set => the overflow interrupt hasn't run yet
+  static bool isOverflowPending() __attribute__((always_inline))
+  {
+    return bitRead(TIFR3, TOV3);
+  }
+
+  // Normal mode, from 0 to 0xFFFF with prescalerIndex, capturing the rising or falling edges of ICP3, with the
+  // capture and overflow interrupts instead of the compare A one. The clock is stopped and any stale flag cleared first
+  static void startCapture(uint8_t prescalerIndex, bool isRising, bool noiseCanceler)
+  {
+    TCCR3A = 0;
+    TCCR3B = 0;
+    TCNT3  = 0;
+    TIFR3  = _BV(ICF3) | _BV(TOV3);
+    TIMSK3 = (TIMSK3 & ~_BV(OCIE3A)) | _BV(ICIE3) | _BV(TOIE3);
+    TCCR3B = prescalerIndex | (isRising ? _BV(ICES3) : 0) | (noiseCanceler ? _BV(ICNC3) : 0);
+  }
+
+  // Disable the capture and overflow interrupts, the counter keeps running
+  static void stopCapture() __attribute__((always_inline))
+  {
+    TIMSK3 &= ~(_BV(ICIE3) | _BV(TOIE3));
+  }
+#endif
+
+#if defined(OCR3B) && defined(OCIE3B)
+  // Compare value of channel 0, 1 or 2 => OCR3A, OCR3B or OCR3C, see TimerChannels
+  static uint16_t getCompare(uint8_t channel) __attribute__((always_inline))
+  {
+  #if defined(OCR3C)
+    if (channel == 2)
+      return OCR3C;
+  #endif
+
+    return (channel == 1) ? OCR3B : OCR3A;
+  }
+
+  static void setCompare(uint8_t channel, uint16_t value) __attribute__((always_inline))
+  {
+    if (channel == 0)
+      OCR3A = value;
+    else if (channel == 1)
+      OCR3B = value;
+  #if defined(OCR3C)
+    else
+      OCR3C = value;
+  #endif
+  }
+
+  // Clear a pending compare interrupt of channel, by writing 1, then enable or disable it.
+  // OCIE3x and OCF3x are bits 1, 2 and 3 for A, B and C
+  static void enableCompareInterrupt(uint8_t channel, bool enable) __attribute__((always_inline))
+  {
+    TIFR3 = _BV(OCF3A + channel);
+    bitWrite(TIMSK3, OCIE3A + channel, enable);
+  }
+
+  // Normal mode, free-running from 0 to 0xFFFF with prescalerIndex, without any OC3x pin
+  static void setNormalMode(uint8_t prescalerIndex) __attribute__((always_inline))
+  {
+    TCCR3A = 0;
+    TCCR3B = prescalerIndex;
+  }
+#endif
+
+  // Toggle the OC3x pin of pinTimer, from digitalPinToTimer(), on each compare match with OCR3A in CTC mode.
+  // OC3B and OC3C compare at count 0, to toggle at the same rate. Returns false if pinTimer isn't on Timer3
+  static bool setToggleOutput(uint8_t pinTimer)
+  {
+    switch (pinTimer)
+    {
+#if defined(TIMER3A) && defined(COM3A0)
+
+      case TIMER3A:
+        TCCR3A = (TCCR3A & ~_BV(COM3A1)) | _BV(COM3A0);
+        return true;
+#endif
+
+#if defined(TIMER3B) && defined(COM3B0)
+
+      case TIMER3B:
+        OCR3B = 0;
+        TCCR3A = (TCCR3A & ~_BV(COM3B1)) | _BV(COM3B0);
+        return true;
+#endif
+
+#if defined(TIMER3C) && defined(COM3C0)
+
+      case TIMER3C:
+        OCR3C = 0;
+        TCCR3A = (TCCR3A & ~_BV(COM3C1)) | _BV(COM3C0);
+        return true;
+#endif
+    }
+
+    return false;
+  }
+
+  // Disconnect all the OC3x pins, back to normal port operation
+  static void clearOutputs()
+  {
+#if defined(COM3A0)
+    TCCR3A &= ~(_BV(COM3A1) | _BV(COM3A0));
+#endif
+#if defined(COM3B0)
+    TCCR3A &= ~(_BV(COM3B1) | _BV(COM3B0));
+#endif
+#if defined(COM3C0)
+    TCCR3A &= ~(_BV(COM3C1) | _BV(COM3C0));
+#endif
+  }
+};
+
+#endif
+
+#if defined(OCR4A) && defined(TIMSK4) && defined(OCIE4A) && defined(TCCR4B)
+
+#define TIMER_REGISTERS_4     true
+
+template<>
+struct TimerRegisters<4>
+{
+#if TIMER_INTERRUPT_USING_ATMEGA_32U4
+  // 10-bit Timer4 of ATmega32U4, counting from 0 to TOP = OCR4C in normal mode, see TimerInterrupt::init()
+  enum { MAX_COUNT = MAX_COUNT_10BIT };
+
+  // The 2 high bits go through TC4H, written before the low byte. OCR4A = TOP too, for the compare A interrupt
+  static void setOCR(uint16_t value) __attribute__((always_inline))
+  {
+    TC4H  = value >> 8;
+    OCR4C = value & 0xFF;
+    TC4H  = value >> 8;
+    OCR4A = value & 0xFF;
+  }
+#else
+  enum { MAX_COUNT = MAX_COUNT_16BIT };
+
+  static void setOCR(uint16_t value) __attribute__((always_inline))
+  {
+    OCR4A = value;
+  }
+#endif
+
+  static void enableInterrupt() __attribute__((always_inline))
+  {
+    bitWrite(TIMSK4, OCIE4A, 1);
+  }
+
+  static void disableInterrupt() __attribute__((always_inline))
+  {
+    bitWrite(TIMSK4, OCIE4A, 0);
+  }
+
+  static bool isInterruptEnabled() __attribute__((always_inline))
+  {
+    return bitRead(TIMSK4, OCIE4A);
+  }
+
+#if TIMER_INTERRUPT_USING_ATMEGA_32U4
+  // CS43:0 bits, 0 => no clock source
+  static void setPrescaler(uint8_t prescalerIndex) __attribute__((always_inline))
+  {
+    TCCR4B = (TCCR4B & 0b11110000) | prescalerIndex;
+  }
+
+  // 1, 2, 4, .. 16384
+  static uint16_t getPrescalerDiv(uint8_t prescalerIndex) __attribute__((always_inline))
+  {
+    return (prescalerIndex == T4_NO_CLOCK_SOURCE) ? 1 : 1U << (prescalerIndex - 1);
+  }
+
+  static void resetCount() __attribute__((always_inline))
+  {
+    TC4H  = 0;
+    TCNT4 = 0;
+  }
+
+  // Reading the low byte first latches the 2 high bits into TC4H
+  static uint16_t getCount() __attribute__((always_inline))
+  {
+    uint8_t low = TCNT4;
+
+    return ((uint16_t) TC4H << 8) | low;
+  }
+
+  static void setCount(uint16_t count) __attribute__((always_inline))
+  {
+    TC4H  = count >> 8;
+    TCNT4 = count & 0xFF;
+  }
+#else
+  static void setPrescaler(uint8_t prescalerIndex) __attribute__((always_inline))
+  {
+    TCCR4B = (TCCR4B & 0b11111000) | prescalerIndex;
+  }
+
+  static uint16_t getPrescalerDiv(uint8_t prescalerIndex) __attribute__((always_inline))
+  {
+    return prescalerDiv[prescalerIndex];
+  }
+
+  static void resetCount() __attribute__((always_inline))
+  {
+    TCNT4 = 0;
+  }
+
+  static uint16_t getCount() __attribute__((always_inline))
+  {
+    return TCNT4;
+  }
+
+  static void setCount(uint16_t count) __attribute__((always_inline))
+  {
+    TCNT4 = count;
+  }
+#endif
+
+  // Clear a pending compare A interrupt, by writing 1
+  static void clearInterruptFlag() __attribute__((always_inline))
+  {
+    TIFR4 = _BV(OCF4A);
+  }
+
+  // Compare A flag still set => its interrupt hasn't run yet
+  static bool isInterruptPending() __attribute__((always_inline))
+  {
+    return bitRead(TIFR4, OCF4A);
+  }
+
+#if defined(WGM42) && !TIMER_INTERRUPT_USING_ATMEGA_32U4
+  // CTC mode, from 0 to OCR4A = OCRValue, with prescalerIndex and the compare A interrupt. The clock is stopped
+  // and any stale compare flag cleared first, see StaticTimer
+  static void startCTC(uint8_t prescalerIndex, uint16_t OCRValue)
+  {
+    TCCR4A = 0;
+    TCCR4B = 0;
+    TCNT4  = 0;
+    OCR4A  = OCRValue;
+    clearInterruptFlag();
+    enableInterrupt();
+    TCCR4B = _BV(WGM42) | prescalerIndex;
+  }
+#endif
+
+#if defined(ICR4) && defined(TIMSK4) && defined(ICIE4) && !TIMER_INTERRUPT_USING_ATMEGA_32U4
+  // Counter latched by the last edge on ICP4, see TimerCapture
+  static uint16_t getCapture() __attribute__((always_inline))
+  {
+    return ICR4;
+  }
+
+  // Overflow flag still set => the overflow interrupt hasn't run yet
+  static bool isOverflowPending() __attribute__((always_inline))
+  {
+    return bitRead(TIFR4, TOV4);
+  }
+
+  // Normal mode, from 0 to 0xFFFF with prescalerIndex, capturing the rising or falling edges of ICP4, with the
+  // capture and overflow interrupts instead of the compare A one. The clock is stopped and any stale flag cleared first
+  static void startCapture(uint8_t prescalerIndex, bool isRising, bool noiseCanceler)
+  {
+    TCCR4A = 0;
+    TCCR4B = 0;
+    TCNT4  = 0;
+    TIFR4  = _BV(ICF4) | _BV(TOV4);
+    TIMSK4 = (TIMSK4 & ~_BV(OCIE4A)) | _BV(ICIE4) | _BV(TOIE4);
+    TCCR4B = prescalerIndex | (isRising ? _BV(ICES4) : 0) | (noiseCanceler ? _BV(ICNC4) : 0);
+  }
+
+  // Disable the capture and overflow interrupts, the counter keeps running
+  static void stopCapture() __attribute__((always_inline))
+  {
+    TIMSK4 &= ~(_BV(ICIE4) | _BV(TOIE4));
+  }
+#endif
+
+#if defined(OCR4B) && defined(OCIE4B) && !TIMER_INTERRUPT_USING_ATMEGA_32U4
+  // Compare value of channel 0, 1 or 2 => OCR4A, OCR4B or OCR4C, see TimerChannels
+  static uint16_t getCompare(uint8_t channel) __attribute__((always_inline))
+  {
+  #if defined(OCR4C)
+    if (channel == 2)
+      return OCR4C;
+  #endif
+
+    return (channel == 1) ? OCR4B : OCR4A;
+  }
+
+  static void setCompare(uint8_t channel, uint16_t value) __attribute__((always_inline))
+  {
+    if (channel == 0)
+      OCR4A = value;
+    else if (channel == 1)
+      OCR4B = value;
+  #if defined(OCR4C)
+    else
+      OCR4C = value;
+  #endif
+  }
+
+  // Clear a pending compare interrupt of channel, by writing 1, then enable or disable it.
+  // OCIE4x and OCF4x are bits 1, 2 and 3 for A, B and C
+  static void enableCompareInterrupt(uint8_t channel, bool enable) __attribute__((always_inline))
+  {
+    TIFR4 = _BV(OCF4A + channel);
+    bitWrite(TIMSK4, OCIE4A + channel, enable);
+  }
+
+  // Normal mode, free-running from 0 to 0xFFFF with prescalerIndex, without any OC4x pin
+  static void setNormalMode(uint8_t prescalerIndex) __attribute__((always_inline))
+  {
+    TCCR4A = 0;
+    TCCR4B = prescalerIndex;
+  }
+#endif
+
+  // Toggle the OC4x pin of pinTimer, from digitalPinToTimer(), on each compare match with OCR4A in CTC mode.
+  // OC4B, OC4C and OC4D compare at count 0, to toggle at the same rate. Returns false if pinTimer isn't on Timer4
+  static bool setToggleOutput(uint8_t pinTimer)
+  {
+#if TIMER_INTERRUPT_USING_ATMEGA_32U4
+    // The TOP of the 10-bit Timer4 of ATmega32U4 is OCR4C, with OCR4A at TOP too. OC4B and OC4D compare at count 0
+    switch (pinTimer)
+    {
+#if defined(TIMER4A) && defined(COM4A0)
+
+      case TIMER4A:
+        TCCR4A = (TCCR4A & ~_BV(COM4A1)) | _BV(COM4A0);
+        return true;
+#endif
+
+#if defined(TIMER4B) && defined(COM4B0)
+
+      case TIMER4B:
+        TC4H  = 0;
+        OCR4B = 0;
+        TCCR4A = (TCCR4A & ~_BV(COM4B1)) | _BV(COM4B0);
+        return true;
+#endif
+
+#if defined(TIMER4D) && defined(COM4D0)
+
+      case TIMER4D:
+        TC4H  = 0;
+        OCR4D = 0;
+        TCCR4C = (TCCR4C & ~_BV(COM4D1)) | _BV(COM4D0);
+        return true;
+#endif
+    }
+#else
+    switch (pinTimer)
+    {
+#if defined(TIMER4A) && defined(COM4A0)
+
+      case TIMER4A:
+        TCCR4A = (TCCR4A & ~_BV(COM4A1)) | _BV(COM4A0);
+        return true;
+#endif
+
+#if defined(TIMER4B) && defined(COM4B0)
+
+      case TIMER4B:
+        OCR4B = 0;
+        TCCR4A = (TCCR4A & ~_BV(COM4B1)) | _BV(COM4B0);
+        return true;
+#endif
+
+#if defined(TIMER4C) && defined(COM4C0)
+
+      case TIMER4C:
+        OCR4C = 0;
+        TCCR4A = (TCCR4A & ~_BV(COM4C1)) | _BV(COM4C0);
+        return true;
+#endif
+    }
+#endif
+
+    return false;
+  }
+
+  // Disconnect all the OC4x pins, back to normal port operation
+  static void clearOutputs()
+  {
+#if defined(COM4A0)
+    TCCR4A &= ~(_BV(COM4A1) | _BV(COM4A0));
+#endif
+#if defined(COM4B0)
+    TCCR4A &= ~(_BV(COM4B1) | _BV(COM4B0));
+#endif
+#if defined(COM4C0)
+    TCCR4A &= ~(_BV(COM4C1) | _BV(COM4C0));
+#endif
+#if defined(COM4D0)
+    TCCR4C &= ~(_BV(COM4D1) | _BV(COM4D0));
+#endif
+  }
+};
+
+#endif
+
+#if defined(OCR5A) && defined(TIMSK5) && defined(OCIE5A) && defined(TCCR5B)
+
+#define TIMER_REGISTERS_5     true
+
+template<>
+struct TimerRegisters<5>
+{
+  enum { MAX_COUNT = MAX_COUNT_16BIT };
+
+  static void setOCR(uint16_t value) __attribute__((always_inline))
+  {
+    OCR5A = value;
+  }
+
+  static void enableInterrupt() __attribute__((always_inline))
+  {
+    bitWrite(TIMSK5, OCIE5A, 1);
+  }
+
+  static void disableInterrupt() __attribute__((always_inline))
+  {
+    bitWrite(TIMSK5, OCIE5A, 0);
+  }
+
+  static bool isInterruptEnabled() __attribute__((always_inline))
+  {
+    return bitRead(TIMSK5, OCIE5A);
+  }
+
+  static void setPrescaler(uint8_t prescalerIndex) __attribute__((always_inline))
+  {
+    TCCR5B = (TCCR5B & 0b11111000) | prescalerIndex;
+  }
+
+  static uint16_t getPrescalerDiv(uint8_t prescalerIndex) __attribute__((always_inline))
+  {
+    return prescalerDiv[prescalerIndex];
+  }
+
+  static void resetCount() __attribute__((always_inline))
+  {
+    TCNT5 = 0;
+  }
+
+  static uint16_t getCount() __attribute__((always_inline))
+  {
+    return TCNT5;
+  }
+
+  static void setCount(uint16_t count) __attribute__((always_inline))
+  {
+    TCNT5 = count;
+  }
+
+  // Clear a pending compare A interrupt, by writing 1
+  static void clearInterruptFlag() __attribute__((always_inline))
+  {
+    TIFR5 = _BV(OCF5A);
+  }
+
+  // Compare A flag still set => its interrupt hasn't run yet
+  static bool isInterruptPending() __attribute__((always_inline))
+  {
+    return bitRead(TIFR5, OCF5A);
+  }
+
+#if defined(WGM52)
+  // CTC mode, from 0 to OCR5A = OCRValue, with prescalerIndex and the compare A interrupt. The clock is stopped
+  // and any stale compare flag cleared first, see StaticTimer
+  static void startCTC(uint8_t prescalerIndex, uint16_t OCRValue)
+  {
+    TCCR5A = 0;
+    TCCR5B = 0;
+    TCNT5  = 0;
+    OCR5A  = OCRValue;
+    clearInterruptFlag();
+    enableInterrupt();
+    TCCR5B = _BV(WGM52) | prescalerIndex;
+  }
+#endif
+
+#if defined(ICR5) && defined(TIMSK5) && defined(ICIE5)
+  // Counter latched by the last edge on ICP5, see TimerCapture
+  static uint16_t getCapture() __attribute__((always_inline))
+  {
+    return ICR5;
+  }
+
+  // Overflow flag still set => the overflow interrupt hasn't run yet
+  static bool isOverflowPending() __attribute__((always_inline))
+  {
+    return bitRead(TIFR5, TOV5);
+  }
+
+  // Normal mode, from 0 to 0xFFFF with prescalerIndex, capturing the rising or falling edges of ICP5, with the
+  // capture and overflow interrupts instead of the compare A one. The clock is stopped and any stale flag cleared first
+  static void startCapture(uint8_t prescalerIndex, bool isRising, bool noiseCanceler)
+  {
+    TCCR5A = 0;
+    TCCR5B = 0;
+    TCNT5  = 0;
+    TIFR5  = _BV(ICF5) | _BV(TOV5);
+    TIMSK5 = (TIMSK5 & ~_BV(OCIE5A)) | _BV(ICIE5) | _BV(TOIE5);
+    TCCR5B = prescalerIndex | (isRising ? _BV(ICES5) : 0) | (noiseCanceler ? _BV(ICNC5) : 0);
+  }
+
+  // Disable the capture and overflow interrupts, the counter keeps running
+  static void stopCapture() __attribute__((always_inline))
+  {
+    TIMSK5 &= ~(_BV(ICIE5) | _BV(TOIE5));
+  }
+#endif
+
+#if defined(OCR5B) && defined(OCIE5B)
+  // Compare value of channel 0, 1 or 2 => OCR5A, OCR5B or OCR5C, see TimerChannels
+  static uint16_t getCompare(uint8_t channel) __attribute__((always_inline))
+  {
+  #if defined(OCR5C)
+    if (channel == 2)
+      return OCR5C;
+  #endif
+
+    return (channel == 1) ? OCR5B : OCR5A;
+  }
+
+  static void setCompare(uint8_t channel, uint16_t value) __attribute__((always_inline))
+  {
+    if (channel == 0)
+      OCR5A = value;
+    else if (channel == 1)
+      OCR5B = value;
+  #if defined(OCR5C)
+    else
+      OCR5C = value;
+  #endif
+  }
+
+  // Clear a pending compare interrupt of channel, by writing 1, then enable or disable it.
+  // OCIE5x and OCF5x are bits 1, 2 and 3 for A, B and C
+  static void enableCompareInterrupt(uint8_t channel, bool enable) __attribute__((always_inline))
+  {
+    TIFR5 = _BV(OCF5A + channel);
+    bitWrite(TIMSK5, OCIE5A + channel, enable);
+  }
+
+  // Normal mode, free-running from 0 to 0xFFFF with prescalerIndex, without any OC5x pin
+  static void setNormalMode(uint8_t prescalerIndex) __attribute__((always_inline))
+  {
+    TCCR5A = 0;
+    TCCR5B = prescalerIndex;
+  }
+#endif
+
+  // Toggle the OC5x pin of pinTimer, from digitalPinToTimer(), on each compare match with OCR5A in CTC mode.
+  // OC5B and OC5C compare at count 0, to toggle at the same rate. Returns false if pinTimer isn't on Timer5
+  static bool setToggleOutput(uint8_t pinTimer)
+  {
+    switch (pinTimer)
+    {
+#if defined(TIMER5A) && defined(COM5A0)
+
+      case TIMER5A:
+        TCCR5A = (TCCR5A & ~_BV(COM5A1)) | _BV(COM5A0);
+        return true;
+#endif
+
+#if defined(TIMER5B) && defined(COM5B0)
+
+      case TIMER5B:
+        OCR5B = 0;
+        TCCR5A = (TCCR5A & ~_BV(COM5B1)) | _BV(COM5B0);
+        return true;
+#endif
+
+#if defined(TIMER5C) && defined(COM5C0)
+
+      case TIMER5C:
+        OCR5C = 0;
+        TCCR5A = (TCCR5A & ~_BV(COM5C1)) | _BV(COM5C0);
+        return true;
+#endif
+    }
+
+    return false;
+  }
+
+  // Disconnect all the OC5x pins, back to normal port operation
+  static void clearOutputs()
+  {
+#if defined(COM5A0)
+    TCCR5A &= ~(_BV(COM5A1) | _BV(COM5A0));
+#endif
+#if defined(COM5B0)
+    TCCR5A &= ~(_BV(COM5B1) | _BV(COM5B0));
+#endif
+#if defined(COM5C0)
+    TCCR5A &= ~(_BV(COM5C1) | _BV(COM5C0));
+#endif
+  }
+};
+
+#endif
+
+#endif    // #ifndef TIMER_REGISTERS_HPP
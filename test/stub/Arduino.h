@@ -0,0 +1,105 @@
+// Host stub of the Arduino API used by the library, for the tests in test/. See test/Makefile.
+// millis() and micros() return fake_millis and fake_micros, set by the tests to inject time and stalls
+#pragma once
+
+#include <iostream>
+#include <iomanip>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifndef F_CPU
+  #define F_CPU 16000000UL
+#endif
+
+#include "avr/io.h"
+
+typedef bool boolean;
+
+extern unsigned long fake_millis, fake_micros;
+
+inline unsigned long millis() { return fake_millis; }
+inline unsigned long micros() { return fake_micros; }
+
+inline void noInterrupts() { SREG &= ~0x80; }
+inline void interrupts() { SREG |= 0x80; }
+
+#define cli() noInterrupts()
+#define sei() interrupts()
+
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+#define bitSet(value, bit) ((value) |= (1UL << (bit)))
+#define bitClear(value, bit) ((value) &= ~(1UL << (bit)))
+#define bitWrite(value, bit, bitvalue) ((bitvalue) ? bitSet(value, bit) : bitClear(value, bit))
+#define _BV(b) (1 << (b))
+#define min(a,b) ((a)<(b)?(a):(b))
+#define max(a,b) ((a)>(b)?(a):(b))
+#define clockCyclesPerMicrosecond() ( F_CPU / 1000000L )
+#define F(x) x
+
+#define OUTPUT        1
+#define INPUT         0
+#define INPUT_PULLUP  2
+#define HIGH          1
+#define LOW           0
+#define CHANGE        1
+#define FALLING       2
+#define RISING        3
+
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t, uint8_t) {}
+inline int digitalRead(uint8_t) { return 0; }
+inline void delay(unsigned long) {}
+inline void delayMicroseconds(unsigned int) {}
+inline int digitalPinToInterrupt(int p) { return p; }
+inline void attachInterrupt(int, void (*)(void), int) {}
+inline void detachInterrupt(int) {}
+
+// Serial output of the library logs, only with stub_print
+extern bool stub_print;
+
+struct Print
+{
+  template<typename T> size_t print(T v) { if (stub_print) std::cout << v; return 0; }
+  size_t print(double v, int d) { if (stub_print) std::cout << std::fixed << std::setprecision(d) << v; return 0; }
+  template<typename T> size_t print(T v, int) { if (stub_print) std::cout << v; return 0; }
+  template<typename T> size_t println(T v) { print(v); if (stub_print) std::cout << "\n"; return 0; }
+  template<typename T> size_t println(T v, int d) { print(v, d); if (stub_print) std::cout << "\n"; return 0; }
+  size_t println() { if (stub_print) std::cout << "\n"; return 0; }
+};
+
+struct HardwareSerial : Print
+{
+  void begin(long) {}
+  operator bool() { return true; }
+};
+
+extern HardwareSerial Serial;
+
+#define NOT_ON_TIMER 0
+#define TIMER0A 1
+#define TIMER0B 2
+#define TIMER1A 3
+#define TIMER1B 4
+#define TIMER1C 5
+#define TIMER2  6
+#define TIMER2A 7
+#define TIMER2B 8
+#define TIMER3A 9
+#define TIMER3B 10
+#define TIMER3C 11
+#define TIMER4A 12
+#define TIMER4B 13
+#define TIMER4C 14
+#define TIMER4D 15
+#define TIMER5A 16
+#define TIMER5B 17
+#define TIMER5C 18
+
+// Mega pins of the OCnA outputs
+inline uint8_t digitalPinToTimer(uint8_t p)
+{
+  return p == 11 ? TIMER1A : p == 12 ? TIMER1B : p == 13 ? TIMER1C : p == 10 ? TIMER2A : p == 5 ? TIMER3A :
+         p == 6 ? TIMER4A : p == 46 ? TIMER5A : NOT_ON_TIMER;
+}
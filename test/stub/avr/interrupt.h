@@ -0,0 +1,4 @@
+#pragma once
+
+// ISRs are plain functions, called by the tests to simulate the interrupts
+#define ISR(v) extern "C" void v(void)
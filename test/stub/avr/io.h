@@ -0,0 +1,297 @@
+// Host stub of the AVR timer registers used by the library, as plain variables. See test/Makefile
+#pragma once
+#include <stdint.h>
+extern volatile uint8_t _r_SREG;
+#define SREG _r_SREG
+extern volatile uint8_t _r_GTCCR;
+#define GTCCR _r_GTCCR
+extern volatile uint8_t _r_ASSR;
+#define ASSR _r_ASSR
+extern volatile uint8_t _r_TCCR1A;
+#define TCCR1A _r_TCCR1A
+extern volatile uint8_t _r_TCCR1B;
+#define TCCR1B _r_TCCR1B
+extern volatile uint8_t _r_TCCR1C;
+#define TCCR1C _r_TCCR1C
+extern volatile uint16_t _r_TCNT1;
+#define TCNT1 _r_TCNT1
+extern volatile uint16_t _r_OCR1A;
+#define OCR1A _r_OCR1A
+extern volatile uint16_t _r_OCR1B;
+#define OCR1B _r_OCR1B
+extern volatile uint16_t _r_OCR1C;
+#define OCR1C _r_OCR1C
+extern volatile uint16_t _r_ICR1;
+#define ICR1 _r_ICR1
+extern volatile uint8_t _r_TIMSK1;
+#define TIMSK1 _r_TIMSK1
+extern volatile uint8_t _r_TIFR1;
+#define TIFR1 _r_TIFR1
+extern volatile uint8_t _r_TCCR2A;
+#define TCCR2A _r_TCCR2A
+extern volatile uint8_t _r_TCCR2B;
+#define TCCR2B _r_TCCR2B
+extern volatile uint8_t _r_TCNT2;
+#define TCNT2 _r_TCNT2
+extern volatile uint8_t _r_OCR2A;
+#define OCR2A _r_OCR2A
+extern volatile uint8_t _r_OCR2B;
+#define OCR2B _r_OCR2B
+extern volatile uint8_t _r_TIMSK2;
+#define TIMSK2 _r_TIMSK2
+extern volatile uint8_t _r_TIFR2;
+#define TIFR2 _r_TIFR2
+extern volatile uint8_t _r_TCCR3A;
+#define TCCR3A _r_TCCR3A
+extern volatile uint8_t _r_TCCR3B;
+#define TCCR3B _r_TCCR3B
+extern volatile uint8_t _r_TCCR3C;
+#define TCCR3C _r_TCCR3C
+extern volatile uint16_t _r_TCNT3;
+#define TCNT3 _r_TCNT3
+extern volatile uint16_t _r_OCR3A;
+#define OCR3A _r_OCR3A
+extern volatile uint16_t _r_OCR3B;
+#define OCR3B _r_OCR3B
+extern volatile uint16_t _r_OCR3C;
+#define OCR3C _r_OCR3C
+extern volatile uint16_t _r_ICR3;
+#define ICR3 _r_ICR3
+extern volatile uint8_t _r_TIMSK3;
+#define TIMSK3 _r_TIMSK3
+extern volatile uint8_t _r_TIFR3;
+#define TIFR3 _r_TIFR3
+extern volatile uint8_t _r_TCCR4A;
+#define TCCR4A _r_TCCR4A
+extern volatile uint8_t _r_TCCR4B;
+#define TCCR4B _r_TCCR4B
+extern volatile uint8_t _r_TCCR4C;
+#define TCCR4C _r_TCCR4C
+extern volatile uint16_t _r_TCNT4;
+#define TCNT4 _r_TCNT4
+extern volatile uint16_t _r_OCR4A;
+#define OCR4A _r_OCR4A
+extern volatile uint16_t _r_OCR4B;
+#define OCR4B _r_OCR4B
+extern volatile uint16_t _r_OCR4C;
+#define OCR4C _r_OCR4C
+extern volatile uint16_t _r_ICR4;
+#define ICR4 _r_ICR4
+extern volatile uint8_t _r_TIMSK4;
+#define TIMSK4 _r_TIMSK4
+extern volatile uint8_t _r_TIFR4;
+#define TIFR4 _r_TIFR4
+extern volatile uint8_t _r_TCCR5A;
+#define TCCR5A _r_TCCR5A
+extern volatile uint8_t _r_TCCR5B;
+#define TCCR5B _r_TCCR5B
+extern volatile uint8_t _r_TCCR5C;
+#define TCCR5C _r_TCCR5C
+extern volatile uint16_t _r_TCNT5;
+#define TCNT5 _r_TCNT5
+extern volatile uint16_t _r_OCR5A;
+#define OCR5A _r_OCR5A
+extern volatile uint16_t _r_OCR5B;
+#define OCR5B _r_OCR5B
+extern volatile uint16_t _r_OCR5C;
+#define OCR5C _r_OCR5C
+extern volatile uint16_t _r_ICR5;
+#define ICR5 _r_ICR5
+extern volatile uint8_t _r_TIMSK5;
+#define TIMSK5 _r_TIMSK5
+extern volatile uint8_t _r_TIFR5;
+#define TIFR5 _r_TIFR5
+
+#define TSM 7
+#define PSRASY 1
+#define PSRSYNC 0
+#define PSR10 0
+
+
+#define ICNC1 7
+#define ICES1 6
+#define WGM13 4
+#define COM1C1 3
+#define COM1C0 2
+#define OCIE1C 3
+#define OCF1C 3
+#define ICIE1 5
+#define ICF1 5
+#define FOC1A 7
+#define FOC1B 6
+#define FOC1C 5
+#define WGM10 0
+#define WGM11 1
+#define WGM12 3
+#define CS10 0
+#define CS11 1
+#define CS12 2
+#define COM1A1 7
+#define COM1A0 6
+#define COM1B1 5
+#define COM1B0 4
+#define OCIE1A 1
+#define OCIE1B 2
+#define TOIE1 0
+#define OCF1A 1
+#define OCF1B 2
+#define TOV1 0
+
+#define WGM20 0
+#define WGM21 1
+#define WGM22 3
+#define CS20 0
+#define CS21 1
+#define CS22 2
+#define COM2A1 7
+#define COM2A0 6
+#define COM2B1 5
+#define COM2B0 4
+#define OCIE2A 1
+#define OCIE2B 2
+#define TOIE2 0
+#define OCF2A 1
+#define OCF2B 2
+#define TOV2 0
+
+#define ICNC3 7
+#define ICES3 6
+#define WGM33 4
+#define COM3C1 3
+#define COM3C0 2
+#define OCIE3C 3
+#define OCF3C 3
+#define ICIE3 5
+#define ICF3 5
+#define FOC3A 7
+#define FOC3B 6
+#define FOC3C 5
+#define WGM30 0
+#define WGM31 1
+#define WGM32 3
+#define CS30 0
+#define CS31 1
+#define CS32 2
+#define COM3A1 7
+#define COM3A0 6
+#define COM3B1 5
+#define COM3B0 4
+#define OCIE3A 1
+#define OCIE3B 2
+#define TOIE3 0
+#define OCF3A 1
+#define OCF3B 2
+#define TOV3 0
+
+#define ICNC4 7
+#define ICES4 6
+#define WGM43 4
+#define COM4C1 3
+#define COM4C0 2
+#define OCIE4C 3
+#define OCF4C 3
+#define ICIE4 5
+#define ICF4 5
+#define FOC4A 7
+#define FOC4B 6
+#define FOC4C 5
+#define WGM40 0
+#define WGM41 1
+#define WGM42 3
+#define CS40 0
+#define CS41 1
+#define CS42 2
+#define COM4A1 7
+#define COM4A0 6
+#define COM4B1 5
+#define COM4B0 4
+#define OCIE4A 1
+#define OCIE4B 2
+#define TOIE4 0
+#define OCF4A 1
+#define OCF4B 2
+#define TOV4 0
+
+#define ICNC5 7
+#define ICES5 6
+#define WGM53 4
+#define COM5C1 3
+#define COM5C0 2
+#define OCIE5C 3
+#define OCF5C 3
+#define ICIE5 5
+#define ICF5 5
+#define FOC5A 7
+#define FOC5B 6
+#define FOC5C 5
+#define WGM50 0
+#define WGM51 1
+#define WGM52 3
+#define CS50 0
+#define CS51 1
+#define CS52 2
+#define COM5A1 7
+#define COM5A0 6
+#define COM5B1 5
+#define COM5B0 4
+#define OCIE5A 1
+#define OCIE5B 2
+#define TOIE5 0
+#define OCF5A 1
+#define OCF5B 2
+#define TOV5 0
+#define FOC2A 7
+#define FOC2B 6
+
+// ATmega32U4 high-speed 10-bit Timer4: 8-bit registers, high 2 bits through TC4H
+#if defined(__AVR_ATmega32U4__)
+#undef WGM42
+#undef ICR4
+#define CS43 3
+#define PINMUX 7
+#define PLLUSB 6
+#define PLLTM1 5
+#define PLLTM0 4
+#define PDIV3 3
+#define PDIV2 2
+#define PDIV1 1
+#define PDIV0 0
+#define PINDIV 4
+#define PLLE 1
+#define PLOCK 0
+#define USBE 7
+extern volatile uint8_t _r_USBCON;
+extern volatile uint8_t _r_TC4H;
+extern volatile uint8_t _r_TCCR4D;
+extern volatile uint8_t _r_TCCR4E;
+extern volatile uint8_t _r_PLLFRQ;
+// PLOCK always set, as if the PLL locked at once
+struct PLLStatus
+{
+  volatile uint8_t v;
+  PLLStatus& operator=(uint8_t b) { v = b; return *this; }
+  PLLStatus& operator&=(uint8_t b) { v &= b; return *this; }
+  PLLStatus& operator|=(uint8_t b) { v |= b; return *this; }
+  operator uint8_t() const { return v | 1; }
+};
+extern PLLStatus _r_PLLCSR;
+#define TC4H _r_TC4H
+#define TCCR4D _r_TCCR4D
+#define TCCR4E _r_TCCR4E
+#define PLLFRQ _r_PLLFRQ
+#define PLLCSR _r_PLLCSR
+#define USBCON _r_USBCON
+struct Reg10
+{
+  volatile uint16_t v;
+  Reg10& operator=(uint8_t low) { v = ((_r_TC4H & 3) << 8) | low; return *this; }
+  operator uint8_t() const { _r_TC4H = v >> 8; return v & 0xFF; }
+};
+extern Reg10 _r10_OCR4A, _r10_OCR4C, _r10_TCNT4;
+#undef OCR4A
+#undef OCR4C
+#undef TCNT4
+#define OCR4A _r10_OCR4A
+#define OCR4C _r10_OCR4C
+#define TCNT4 _r10_TCNT4
+#endif
@@ -0,0 +1,60 @@
+// Host stub: time, Serial and the AVR timer registers. See test/Makefile
+#include "Arduino.h"
+unsigned long fake_millis, fake_micros;
+HardwareSerial Serial;
+volatile uint8_t _r_SREG;
+volatile uint8_t _r_GTCCR;
+volatile uint8_t _r_ASSR;
+volatile uint8_t _r_TCCR1A;
+volatile uint8_t _r_TCCR1B;
+volatile uint8_t _r_TCCR1C;
+volatile uint16_t _r_TCNT1;
+volatile uint16_t _r_OCR1A;
+volatile uint16_t _r_OCR1B;
+volatile uint16_t _r_OCR1C;
+volatile uint16_t _r_ICR1;
+volatile uint8_t _r_TIMSK1;
+volatile uint8_t _r_TIFR1;
+volatile uint8_t _r_TCCR2A;
+volatile uint8_t _r_TCCR2B;
+volatile uint8_t _r_TCNT2;
+volatile uint8_t _r_OCR2A;
+volatile uint8_t _r_OCR2B;
+volatile uint8_t _r_TIMSK2;
+volatile uint8_t _r_TIFR2;
+volatile uint8_t _r_TCCR3A;
+volatile uint8_t _r_TCCR3B;
+volatile uint8_t _r_TCCR3C;
+volatile uint16_t _r_TCNT3;
+volatile uint16_t _r_OCR3A;
+volatile uint16_t _r_OCR3B;
+volatile uint16_t _r_OCR3C;
+volatile uint16_t _r_ICR3;
+volatile uint8_t _r_TIMSK3;
+volatile uint8_t _r_TIFR3;
+volatile uint8_t _r_TCCR4A;
+volatile uint8_t _r_TCCR4B;
+volatile uint8_t _r_TCCR4C;
+volatile uint16_t _r_TCNT4;
+volatile uint16_t _r_OCR4A;
+volatile uint16_t _r_OCR4B;
+volatile uint16_t _r_OCR4C;
+volatile uint16_t _r_ICR4;
+volatile uint8_t _r_TIMSK4;
+volatile uint8_t _r_TIFR4;
+volatile uint8_t _r_TCCR5A;
+volatile uint8_t _r_TCCR5B;
+volatile uint8_t _r_TCCR5C;
+volatile uint16_t _r_TCNT5;
+volatile uint16_t _r_OCR5A;
+volatile uint16_t _r_OCR5B;
+volatile uint16_t _r_OCR5C;
+volatile uint16_t _r_ICR5;
+volatile uint8_t _r_TIMSK5;
+volatile uint8_t _r_TIFR5;
+bool stub_print = false;
+#if defined(__AVR_ATmega32U4__)
+volatile uint8_t _r_TC4H, _r_TCCR4D, _r_TCCR4E, _r_PLLFRQ = 0b0100, _r_USBCON;
+PLLStatus _r_PLLCSR = { _BV(PINDIV) | _BV(PLLE) };
+Reg10 _r10_OCR4A, _r10_OCR4C = { 0xFF }, _r10_TCNT4;
+#endif
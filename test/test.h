@@ -0,0 +1,18 @@
+// Minimal checks for the host tests. See test/Makefile
+#pragma once
+
+#include <stdio.h>
+
+static int failures = 0;
+
+#define CHECK(cond) \
+  do { if (!(cond)) { printf("%s:%d: FAILED: %s\n", __FILE__, __LINE__, #cond); failures++; } } while (0)
+
+#define CHECK_EQUAL(actual, expected) \
+  do { long a_ = (long) (actual), e_ = (long) (expected); \
+       if (a_ != e_) { printf("%s:%d: FAILED: %s = %ld, expected %ld\n", __FILE__, __LINE__, #actual, a_, e_); failures++; } \
+  } while (0)
+
+// end of main()
+#define TEST_RESULT(name) \
+  ( printf("%s: %s\n", name, failures ? "FAILED" : "OK"), failures ? 1 : 0 )
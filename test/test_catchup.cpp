@@ -0,0 +1,99 @@
+// Catch-up policies of ISR_TimerN, see setCatchUp(): run() is called every 1ms, with stalls injected through the
+// millis() stub, and the calls of each policy are checked against the deadlines really elapsed
+#define ISR_TIMER_CATCHUP   true
+
+#include "ISR_Timer.h"
+#include "test.h"
+
+#define INTERVAL_MS   10
+#define STALL_MS      99          // no run() from 901 to 999 of each second
+#define END_MS        10050       // so that the bursts of the last stall are caught up
+
+enum { SKIP, BURST, COALESCE, COUNTED, NUM_TIMERS };
+
+ISR_TimerN<NUM_TIMERS> ISR_timer;
+
+long          calls[NUM_TIMERS];
+long          callsThisRun[NUM_TIMERS];
+long          maxCallsPerRun[NUM_TIMERS];
+unsigned long coalescedRuns;
+unsigned long maxMissedSkip;
+
+void count(void* p)
+{
+  int k = (intptr_t) p;
+
+  calls[k]++;
+  callsThisRun[k]++;
+}
+
+void countMissed(void* p, unsigned long missedRuns)
+{
+  count(p);
+  coalescedRuns += 1 + missedRuns;
+}
+
+bool isStalled(unsigned long ms)
+{
+  return (ms % 1000) > 1000 - STALL_MS - 1;
+}
+
+int main()
+{
+  fake_millis = 0;
+
+  int skip      = ISR_timer.setInterval(INTERVAL_MS, count, (void*) SKIP);
+  int burst     = ISR_timer.setInterval(INTERVAL_MS, count, (void*) BURST);
+  int coalesce  = ISR_timer.setInterval(INTERVAL_MS, countMissed, (void*) COALESCE);
+
+  CHECK(skip >= 0);
+  CHECK(ISR_timer.setCatchUp(burst, ISR_timer.CATCHUP_BURST, 2));
+  CHECK(coalesce >= 0);
+  CHECK(!ISR_timer.setCatchUp(skip, 3));
+
+  int counted = -1;
+
+  for (fake_millis = 1; fake_millis <= END_MS; fake_millis++)
+  {
+    // 20 runs of 10ms from 850, across the stall of the first second
+    if (fake_millis == 850)
+    {
+      counted = ISR_timer.setTimer(INTERVAL_MS, count, (void*) COUNTED, 20);
+      CHECK(ISR_timer.setCatchUp(counted, ISR_timer.CATCHUP_BURST, 3));
+    }
+
+    if (isStalled(fake_millis))
+      continue;
+
+    memset(callsThisRun, 0, sizeof(callsThisRun));
+
+    ISR_timer.run();
+
+    for (int k = 0; k < NUM_TIMERS; k++)
+      maxCallsPerRun[k] = max(maxCallsPerRun[k], callsThisRun[k]);
+  }
+
+  long deadlines  = END_MS / INTERVAL_MS;
+  long stalls     = END_MS / 1000;
+
+  // CATCHUP_SKIP: once at the end of each stall, the 9 deadlines within it are dropped
+  CHECK_EQUAL(calls[SKIP], deadlines - stalls * (STALL_MS / INTERVAL_MS));
+  CHECK_EQUAL(maxCallsPerRun[SKIP], 1);
+
+  // CATCHUP_BURST: all the deadlines, replayed at most 2 per run()
+  CHECK_EQUAL(calls[BURST], deadlines);
+  CHECK_EQUAL(maxCallsPerRun[BURST], 2);
+
+  // CATCHUP_COALESCE: called as CATCHUP_SKIP, but told how many runs it stands for
+  CHECK_EQUAL(calls[COALESCE], calls[SKIP]);
+  CHECK_EQUAL(coalescedRuns, deadlines);
+  CHECK_EQUAL(maxCallsPerRun[COALESCE], 1);
+
+  // counted CATCHUP_BURST: exactly its 20 runs, 3 at most per run(), then deleted
+  CHECK_EQUAL(calls[COUNTED], 20);
+  CHECK_EQUAL(maxCallsPerRun[COUNTED], 3);
+  CHECK(!ISR_timer.isEnabled(counted));
+  CHECK_EQUAL(ISR_timer.getNumTimers(), 3);
+
+  return TEST_RESULT("test_catchup");
+}
@@ -0,0 +1,133 @@
+// Prescaler and OCR planner of TimerInterrupt::setFrequency(), swept over frequencies and intervals on Timer1 and
+// Timer2: the chosen prescaler must have the smallest error of all, and getErrorPpm() must match. Also checks the
+// 32-bit mulDiv() it's built on against 64-bit math, and reports the max error in ppm
+#define USE_TIMER_1     true
+#define USE_TIMER_2     true
+
+#include "TimerInterrupt.h"
+#include "test.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+void doNothing() {}
+
+void checkMulDiv(uint32_t a, uint32_t b, uint32_t c)
+{
+  uint64_t  product   = (uint64_t) a * b;
+  uint64_t  expected  = product / c;
+  uint32_t  remainder;
+  uint32_t  quotient  = TimerInterrupt::mulDiv(a, b, c, remainder);
+
+  if (expected >= 0xFFFFFFFFULL)
+  {
+    CHECK_EQUAL(quotient, 0xFFFFFFFFUL);
+    return;
+  }
+
+  if ( (quotient != expected) || (remainder != product % c) )
+  {
+    printf("mulDiv(%lu, %lu, %lu) = %lu r %lu\n", (unsigned long) a, (unsigned long) b, (unsigned long) c,
+           (unsigned long) quotient, (unsigned long) remainder);
+    failures++;
+  }
+
+  uint32_t fraction = TimerInterrupt::fraction32(product % c, c);
+
+  CHECK_EQUAL(fraction, (uint32_t) ( ((product % c) << 32) / c ));
+}
+
+// relative error of the actual period vs. den / num s
+double periodError(uint32_t num, uint32_t den, uint32_t counts, unsigned int div)
+{
+  return (double) counts * div * num / ((double) F_CPU * den) - 1;
+}
+
+// Sweeps one timer, returns the max error in ppm
+double sweep(TimerInterrupt& timer, const char* name, const unsigned int* divs, uint8_t numDivs, uint32_t maxCount)
+{
+  double maxPpm = 0;
+  double sumPpm = 0;
+  long   numPeriods = 0;
+
+  for (int pass = 0; pass < 2; pass++)
+  {
+    // pass 0: 0.01Hz to 200kHz, pass 1: intervals of 1ms to 100s
+    for (double x = (pass == 0) ? 0.01 : 1; x < ( (pass == 0) ? 200000 : 100000 ); x *= 1.0137)
+    {
+      uint32_t num = (pass == 0) ? (uint32_t) (x * 1000 + 0.5) : 1000;
+      uint32_t den = (pass == 0) ? 1000 : (uint32_t) x;
+
+      CHECK(timer.setFrequency(num, den, TimerDelegate(doNothing)));
+
+      unsigned int  div     = timer.getPrescalerDiv();
+      uint32_t      counts  = timer.get_OCRValue() + 1;
+      double        error   = fabs(periodError(num, den, counts, div));
+
+      // no other prescaler, with its own rounded counts, does better
+      for (uint8_t i = 0; i < numDivs; i++)
+      {
+        double exact  = (double) F_CPU * den / ((double) num * divs[i]);
+        double other  = floor(exact + 0.5);
+
+        if ( (other < 1) || (other > 16384.0 * (maxCount + 1)) )
+          continue;
+
+        if (fabs(periodError(num, den, other, divs[i])) < error - 1E-12)
+        {
+          printf("%s %lu/%lu Hz: prescaler %u, OCR %lu worse than %u\n", name, (unsigned long) num,
+                 (unsigned long) den, div, (unsigned long) (counts - 1), divs[i]);
+          failures++;
+        }
+      }
+
+      // getErrorPpm() truncates to whole ppm
+      CHECK( fabs(timer.getErrorPpm() - periodError(num, den, counts, div) * 1E6) < 1.01 );
+
+      maxPpm = fmax(maxPpm, error * 1E6);
+      sumPpm += error * 1E6;
+      numPeriods++;
+    }
+  }
+
+  printf("%s: max error %.1f ppm, mean %.1f ppm over %ld periods\n", name, maxPpm, sumPpm / numPeriods, numPeriods);
+
+  return maxPpm;
+}
+
+int main()
+{
+  // edge cases, then random ones
+  checkMulDiv(0, 0, 1);
+  checkMulDiv(0xFFFFFFFFUL, 0xFFFFFFFFUL, 0xFFFFFFFFUL);
+  checkMulDiv(0xFFFFFFFFUL, 1, 1);
+  checkMulDiv(0xFFFFFFFEUL, 1, 1);
+  checkMulDiv(0x80000000UL, 2, 1);
+  checkMulDiv(0x80000000UL, 2, 2);
+  checkMulDiv(F_CPU, 1000000UL, 3);
+  checkMulDiv(F_CPU, 1000000UL, 0xFFFFFFFFUL);
+
+  srand(1);
+
+  for (long i = 0; i < 200000; i++)
+  {
+    uint32_t a = ( (uint32_t) rand() << 16 ) ^ rand();
+    uint32_t b = ( (uint32_t) rand() << 16 ) ^ rand();
+    uint32_t c = ( (uint32_t) rand() << 16 ) ^ rand();
+
+    // also small ones
+    checkMulDiv(a >> (i % 32), b >> (i % 29), (c >> (i % 31)) | 1);
+  }
+
+  const unsigned int divs1[] = { 1, 8, 64, 256, 1024 };
+  const unsigned int divs2[] = { 1, 8, 32, 64, 128, 256, 1024 };
+
+  ITimer1.init();
+  ITimer2.init();
+
+  // 200kHz on a 16MHz clock is 80 cycles, so the rounding alone is up to 1 / 160, about 6000 ppm
+  CHECK(sweep(ITimer1, "Timer1", divs1, 5, 0xFFFF) < 6300);
+  CHECK(sweep(ITimer2, "Timer2", divs2, 7, 0xFF) < 6300);
+
+  return TEST_RESULT("test_frequency_sweep");
+}
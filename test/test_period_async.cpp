@@ -0,0 +1,80 @@
+// Periods changed by setPeriodTicksAsync() on Timer1: applied by the ISR at the end of the running period, they keep
+// a frequency for getErrorPpm(), getActualFrequency() and the duration of a later reattachInterrupt(duration), which
+// must run the callback for all the periods within it, then detach
+#define USE_TIMER_1     true
+
+#include "TimerInterrupt.h"
+#include "test.h"
+
+#include <math.h>
+
+long calls;
+
+void count()
+{
+  calls++;
+}
+
+// Runs the compare interrupts up to duration (in ms) of the running period, or until the timer is detached
+void runFor(unsigned long duration)
+{
+  double cycles = 0;
+
+  while ( ITimer1.isEnabled() && (cycles < duration * (F_CPU / 1000.0)) )
+  {
+    cycles += (double) (OCR1A + 1) * ITimer1.getPrescalerDiv();
+    TIMER1_COMPA_vect();
+  }
+}
+
+// periodTicks counts of the running prescaler, then duration (in ms) of callbacks
+void checkPeriodTicks(uint32_t periodTicks, unsigned long duration)
+{
+  CHECK(ITimer1.setPeriodTicksAsync(periodTicks));
+  CHECK(ITimer1.isPeriodPending());
+
+  // Applied at the end of the running period
+  TIMER1_COMPA_vect();
+
+  CHECK(!ITimer1.isPeriodPending());
+  CHECK_EQUAL(ITimer1.getPeriodTicks(), periodTicks);
+  CHECK_EQUAL(ITimer1.getErrorPpm(), 0);
+
+  double hz = (double) F_CPU / ((double) periodTicks * ITimer1.getPrescalerDiv());
+
+  CHECK( fabs(ITimer1.getActualFrequency() / hz - 1) < 1E-6 );
+
+  // Callbacks for the duration only
+  calls = 0;
+  ITimer1.reattachInterrupt(duration);
+
+  long periods = (long) (hz * duration / 1000);
+
+  CHECK(periods > 0);
+  CHECK_EQUAL(ITimer1.getCount(), periods);
+
+  runFor(2 * duration);
+
+  CHECK_EQUAL(calls, periods);
+  CHECK(!ITimer1.isEnabled());
+}
+
+int main()
+{
+  ITimer1.init();
+
+  // From 1kHz, on the prescaler of 64
+  CHECK(ITimer1.setFrequency(1000, 1, TimerDelegate(count)));
+
+  checkPeriodTicks(100, 250);
+  checkPeriodTicks(2500, 250);
+  checkPeriodTicks(12345, 1000);
+
+  // From 1Hz, on the prescaler of 1024, then a long period of several compares
+  CHECK(ITimer1.setFrequency(1, 1, TimerDelegate(count)));
+
+  checkPeriodTicks(3000, 1000);
+  checkPeriodTicks(100000, 20000);
+
+  return TEST_RESULT("test_period_async");
+}
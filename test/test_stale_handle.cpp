@@ -0,0 +1,202 @@
+// Stale handles of ISR_TimerN and ISR_TimerWheel: deleting or changing a timer after its one-shot or counted runs
+// already freed its slot must do nothing, nor push the slot twice on the free list. Also checks that a deferred
+// one-shot, deleted and replaced by its own callback before drain() frees it, doesn't take its successor along
+#define ISR_TIMER_DEFERRED          true
+#define ISR_TIMER_WHEEL_MAX_TIMERS  4
+
+#include "ISR_Timer.h"
+#include "ISR_TimerWheel.h"
+#include "test.h"
+
+#define NUM_TIMERS    4
+
+ISR_TimerN<NUM_TIMERS> ISR_timer;
+ISR_TimerWheel         wheel;
+
+long  calls;
+int   handle;
+int   successor;
+
+void count()
+{
+  calls++;
+}
+
+// deletes its own timer, then reuses the slot
+void replaceItself()
+{
+  calls++;
+
+  ISR_timer.deleteTimer(handle);
+  successor = ISR_timer.setInterval(100, count);
+}
+
+// With a sound free list, each slot is handed out once, so all the handles differ, then there's none left
+void checkFreeList()
+{
+  int handles[NUM_TIMERS];
+
+  CHECK_EQUAL(ISR_timer.getNumTimers(), 0);
+
+  for (int i = 0; i < NUM_TIMERS; i++)
+  {
+    handles[i] = ISR_timer.setInterval(100, count);
+
+    CHECK(handles[i] >= 0);
+
+    for (int j = 0; j < i; j++)
+      CHECK(handles[i] != handles[j]);
+  }
+
+  CHECK_EQUAL(ISR_timer.setInterval(100, count), -1);
+  CHECK_EQUAL(ISR_timer.getNumTimers(), NUM_TIMERS);
+
+  for (int i = 0; i < NUM_TIMERS; i++)
+    ISR_timer.deleteTimer(handles[i]);
+
+  CHECK_EQUAL(ISR_timer.getNumTimers(), 0);
+}
+
+// Same as checkFreeList(), for the wheel
+void checkWheelFreeList()
+{
+  int handles[ISR_TIMER_WHEEL_MAX_TIMERS];
+
+  CHECK_EQUAL(wheel.getNumTimers(), 0);
+
+  for (int i = 0; i < ISR_TIMER_WHEEL_MAX_TIMERS; i++)
+  {
+    handles[i] = wheel.setInterval(100, count);
+
+    CHECK(handles[i] >= 0);
+
+    for (int j = 0; j < i; j++)
+      CHECK(handles[i] != handles[j]);
+  }
+
+  CHECK_EQUAL(wheel.setInterval(100, count), -1);
+
+  for (int i = 0; i < ISR_TIMER_WHEEL_MAX_TIMERS; i++)
+    wheel.deleteTimer(handles[i]);
+
+  CHECK_EQUAL(wheel.getNumTimers(), 0);
+}
+
+void runUntil(unsigned long ms)
+{
+  while (fake_millis < ms)
+  {
+    fake_millis++;
+    ISR_timer.run();
+  }
+}
+
+int main()
+{
+  fake_millis = 0;
+
+  // one-shot, freed by run() once fired
+  int oneShot = ISR_timer.setTimeout(10, count);
+
+  CHECK(oneShot >= 0);
+  runUntil(20);
+  CHECK_EQUAL(calls, 1);
+  CHECK_EQUAL(ISR_timer.getNumTimers(), 0);
+
+  ISR_timer.deleteTimer(oneShot);
+  ISR_timer.deleteTimer(oneShot);
+  ISR_timer.restartTimer(oneShot);
+  CHECK(!ISR_timer.changeInterval(oneShot, 50));
+  CHECK(!ISR_timer.setPhase(oneShot, 5));
+  CHECK(!ISR_timer.isEnabled(oneShot));
+  CHECK_EQUAL(ISR_timer.getNumTimers(), 0);
+  checkFreeList();
+
+  // counted, freed after its 3 runs
+  calls = 0;
+
+  int counted = ISR_timer.setTimer(10, count, 3);
+
+  runUntil(100);
+  CHECK_EQUAL(calls, 3);
+
+  ISR_timer.deleteTimer(counted);
+  checkFreeList();
+
+  // the slot of a fired one-shot reused by a new timer, which the stale handle mustn't delete
+  oneShot = ISR_timer.setTimeout(10, count);
+  runUntil(120);
+
+  int reused = ISR_timer.setInterval(100, count);
+
+  CHECK(reused != oneShot);
+  CHECK_EQUAL(reused & 0xFF, oneShot & 0xFF);
+
+  ISR_timer.deleteTimer(oneShot);
+  CHECK(ISR_timer.isEnabled(reused));
+  CHECK_EQUAL(ISR_timer.getNumTimers(), 1);
+
+  ISR_timer.deleteTimer(reused);
+  checkFreeList();
+
+  // deferred one-shot deleted before drain(): not called, and not freed again
+  calls = 0;
+  oneShot = ISR_timer.setTimeout(10, count);
+  ISR_timer.setDeferred(oneShot);
+  runUntil(140);
+  ISR_timer.deleteTimer(oneShot);
+
+  CHECK_EQUAL(ISR_timer.drain(), 0);
+  CHECK_EQUAL(calls, 0);
+  checkFreeList();
+
+  // deferred one-shot replaced by its own callback in the same slot: drain() keeps the successor
+  handle = ISR_timer.setTimeout(10, replaceItself);
+  ISR_timer.setDeferred(handle);
+  runUntil(160);
+
+  CHECK_EQUAL(ISR_timer.drain(), 1);
+  CHECK_EQUAL(calls, 1);
+  CHECK_EQUAL(successor & 0xFF, handle & 0xFF);
+  CHECK(ISR_timer.isEnabled(successor));
+  CHECK_EQUAL(ISR_timer.getNumTimers(), 1);
+
+  ISR_timer.deleteTimer(successor);
+  checkFreeList();
+
+  // wheel: one-shot and counted timers freed by run(), then deleted and changed through their stale handles
+  wheel.init();
+  calls = 0;
+  oneShot = wheel.setTimeout(5, count);
+  counted = wheel.setTimer(3, count, 2);
+
+  for (int i = 0; i < 10; i++)
+    wheel.run();
+
+  CHECK_EQUAL(calls, 3);
+  CHECK_EQUAL(wheel.getNumTimers(), 0);
+
+  wheel.deleteTimer(oneShot);
+  wheel.deleteTimer(counted);
+  wheel.deleteTimer(counted);
+  CHECK(!wheel.changeInterval(oneShot, 50));
+  CHECK(!wheel.isEnabled(counted));
+  CHECK_EQUAL(wheel.getNumTimers(), 0);
+  checkWheelFreeList();
+
+  // the slot of the fired one-shot reused, the stale handle mustn't delete the new timer
+  oneShot = wheel.setTimeout(2, count);
+
+  for (int i = 0; i < 3; i++)
+    wheel.run();
+
+  reused = wheel.setInterval(100, count);
+  wheel.deleteTimer(oneShot);
+  CHECK(wheel.isEnabled(reused));
+  CHECK_EQUAL(wheel.getNumTimers(), 1);
+
+  wheel.deleteTimer(reused);
+  checkWheelFreeList();
+
+  return TEST_RESULT("test_stale_handle");
+}
@@ -0,0 +1,148 @@
+// 10-bit Timer4 of ATmega32U4, simulated at the register level: the period is read back from OCR4C (through TC4H)
+// and the CS43:0 prescaler, for each clock source of setTimer4Clock(), and compared with the requested frequency,
+// getErrorPpm() and the PLL postscaler in PLLFRQ. Also checks that 64MHz isn't allowed to relock the PLL of a running
+// USB, and the one-shot interval of tickless mode on the PLL
+#define USE_TIMER_4     true
+
+#include "TimerInterrupt.h"
+#include "test.h"
+
+#include <math.h>
+
+long calls;
+
+void count()
+{
+  calls++;
+}
+
+// Timer4 clock cycles of one compare period, as programmed in the registers
+double comparePeriodCycles()
+{
+  uint16_t  top = _r10_OCR4C.v;
+  uint8_t   cs  = TCCR4B & 0x0F;
+
+  // The compare A interrupt comes at TOP, only if OCR4A == OCR4C
+  CHECK_EQUAL(_r10_OCR4A.v, top);
+  CHECK(top <= MAX_COUNT_10BIT);
+  CHECK( (cs >= 1) && (cs <= 15) );
+
+  return (double) (top + 1) * (1UL << (cs - 1));
+}
+
+// Runs the compare interrupts up to the next callback, returns the Timer4 clock cycles elapsed
+double runToCallback()
+{
+  long    calls0  = calls;
+  double  cycles  = 0;
+
+  for (int i = 0; (i < 100000) && (calls == calls0); i++)
+  {
+    cycles += comparePeriodCycles();
+    TIMER4_COMPA_vect();
+  }
+
+  CHECK_EQUAL(calls, calls0 + 1);
+
+  return cycles;
+}
+
+double clockOf(uint8_t clockSource)
+{
+  return (clockSource == TIMER4_CLOCK_CPU) ? F_CPU : (clockSource == TIMER4_CLOCK_PLL_48MHZ) ? 48E6 : 64E6;
+}
+
+void checkFrequency(uint8_t clockSource, uint32_t milliHz)
+{
+  CHECK(ITimer4.setTimer4Clock(clockSource));
+  CHECK(ITimer4.setFrequency(milliHz, 1000, TimerDelegate(count)));
+
+  // The first period may start within a chunk
+  runToCallback();
+
+  double hz       = clockOf(clockSource) / runToCallback();
+  double errorPpm = (hz * 1000 / milliHz - 1) * 1E6;
+
+  // getErrorPpm() is the error of the period, truncated to whole ppm
+  if ( (fabs(errorPpm) > 200) || (fabs(ITimer4.getErrorPpm() + errorPpm) > 1.5) )
+  {
+    printf("clock %d, %lu mHz: %.4f Hz, error %.1f ppm, getErrorPpm() %ld\n", clockSource, (unsigned long) milliHz, hz,
+           errorPpm, ITimer4.getErrorPpm());
+    failures++;
+  }
+}
+
+// One-shot interval of tickless mode, converted from CPU cycles to Timer4 clock cycles
+void checkNextInterval(uint8_t clockSource, unsigned long intervalMicros)
+{
+  CHECK(ITimer4.setTimer4Clock(clockSource));
+  CHECK(ITimer4.setFrequency(1000, 1, TimerDelegate(count)));
+
+  ITimer4.setNextIntervalMicros(intervalMicros);
+
+  CHECK_EQUAL(_r10_TCNT4.v, 0);
+
+  // Rounded to the count of the prescaler
+  double div      = 1UL << ((TCCR4B & 0x0F) - 1);
+  double expected = clockOf(clockSource) * intervalMicros / 1E6;
+
+  CHECK( fabs(runToCallback() - expected) <= div / 2 );
+}
+
+int main()
+{
+  // Normal mode, counting from 0 to TOP = OCR4C, on the CPU clock
+  ITimer4.init();
+
+  CHECK_EQUAL(TCCR4A, 0);
+  CHECK_EQUAL(TCCR4C, 0);
+  CHECK_EQUAL(TCCR4D, 0);
+  CHECK_EQUAL(TCCR4E, 0);
+  CHECK_EQUAL(PLLFRQ & (_BV(PLLTM1) | _BV(PLLTM0)), 0);
+
+  const uint32_t milliHz[] = { 500, 1000, 50000, 1000000, 3333000, 20000000, 100000000, 250000000 };
+
+  for (uint32_t f : milliHz)
+    checkFrequency(TIMER4_CLOCK_CPU, f);
+
+  CHECK_EQUAL(PLLFRQ & (_BV(PLLTM1) | _BV(PLLTM0)), 0);
+
+  // 48MHz: the PLL at 48MHz, postscaler 1
+  for (uint32_t f : milliHz)
+    checkFrequency(TIMER4_CLOCK_PLL_48MHZ, f);
+
+  CHECK_EQUAL(PLLFRQ & (_BV(PLLTM1) | _BV(PLLTM0)), _BV(PLLTM0));
+  CHECK(PLLCSR & _BV(PLLE));
+
+  // 64MHz refused while USB runs on the 48MHz PLL, as relocking it would drop the USB connection
+  USBCON = _BV(USBE);
+
+  CHECK(!ITimer4.setTimer4Clock(TIMER4_CLOCK_PLL_64MHZ));
+  CHECK_EQUAL(PLLFRQ & 0x0F, _BV(PDIV2));
+  CHECK_EQUAL(PLLFRQ & (_BV(PLLTM1) | _BV(PLLTM0)), _BV(PLLTM0));
+
+  USBCON = 0;
+
+  // 64MHz: the PLL at 96MHz, USB still at 48MHz through PLLUSB, postscaler 1.5
+  for (uint32_t f : milliHz)
+    checkFrequency(TIMER4_CLOCK_PLL_64MHZ, f);
+
+  CHECK_EQUAL(PLLFRQ & (_BV(PLLTM1) | _BV(PLLTM0)), _BV(PLLTM1));
+  CHECK_EQUAL(PLLFRQ & 0x0F, _BV(PDIV3) | _BV(PDIV1));
+  CHECK(PLLFRQ & _BV(PLLUSB));
+
+  // Already at 96MHz, nothing to relock, even with USB
+  USBCON = _BV(USBE);
+  checkFrequency(TIMER4_CLOCK_PLL_64MHZ, 1000000);
+
+  // 48MHz again, now from the 96MHz PLL, postscaler 2
+  checkFrequency(TIMER4_CLOCK_PLL_48MHZ, 1000000);
+
+  CHECK_EQUAL(PLLFRQ & (_BV(PLLTM1) | _BV(PLLTM0)), _BV(PLLTM1) | _BV(PLLTM0));
+
+  checkNextInterval(TIMER4_CLOCK_PLL_48MHZ, 1000);
+  checkNextInterval(TIMER4_CLOCK_PLL_48MHZ, 250000);
+  checkNextInterval(TIMER4_CLOCK_CPU, 1000);
+
+  return TEST_RESULT("test_timer4_32u4");
+}